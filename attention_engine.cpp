@@ -0,0 +1,186 @@
+#include "attention_engine.h"
+#include "cpu_attention.h"
+#include "host_buffer.h"
+#include <chrono>
+#include <cstdio>
+
+AttentionEngine::AttentionEngine()
+    : is_planned(false), plan_shape(), plan_options(), cpu_out(NULL),
+      in_flight(0), stopping(false) {}
+
+AttentionEngine::~AttentionEngine() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    if (worker.joinable()) worker.join();
+    if (cpu_out) host_buffer_free(cpu_out);
+}
+
+// --------------------------------------------------------
+// Plan - shape 검사, backend 확정, scratch 확보
+// --------------------------------------------------------
+bool AttentionEngine::plan(const attention_shape& shape, const attention_options& options) {
+    if (shape.seq_len < 1 || shape.seq_len > N || shape.head_dim < 1
+        || shape.head_dim > dk || shape.head_dim > dv) {
+        fprintf(stderr, "AttentionEngine::plan: seq_len=%d head_dim=%d exceeds N=%d, dk=%d, dv=%d\n",
+                shape.seq_len, shape.head_dim, N, dk, dv);
+        return false;
+    }
+
+    drain();
+    std::lock_guard<std::mutex> lock(run_mutex);
+
+    if (options.backend == ATTN_BACKEND_CPU && cpu_out == NULL) {
+        cpu_out = (float (*)[dv])host_buffer_alloc(sizeof(float) * N * dv);
+    }
+    plan_shape = shape;
+    plan_options = options;
+#if BLOCK_SPARSE
+    int n = 0;
+    int num_q_tiles = (shape.seq_len + Br - 1) / Br;
+    for (int t = 0; t < num_q_tiles; t++) {
+        block_ptr[t] = n;
+        int num_kv_blocks = (kv_range_end(t * Br, shape.seq_len, shape.causal) + Bc - 1) / Bc;
+        for (int jb = 0; jb < num_kv_blocks; jb++) {
+            block_idx[n++] = jb;
+        }
+    }
+    block_ptr[num_q_tiles] = n;
+#endif
+    is_planned = true;
+    return true;
+}
+
+const char* AttentionEngine::backend_name() const {
+    return plan_options.backend == ATTN_BACKEND_CPU ? "cpu" : "hls";
+}
+
+// --------------------------------------------------------
+// 실행 1회 (run_mutex 안) - 할당 없음
+// HLS 커널 포트는 non-const 지만 Q/K/V/scale 은 읽기만 함
+// --------------------------------------------------------
+double AttentionEngine::run(const job& j) {
+    const attention_shape& s = plan_shape;
+    auto t_start = std::chrono::steady_clock::now();
+
+    if (plan_options.backend == ATTN_BACKEND_CPU) {
+        compute_attention_cpu(j.Q, j.K, j.V, cpu_out, j.scale_Q, j.scale_K, j.scale_V,
+                              s.seq_len, s.head_dim, s.causal, plan_options.cpu_threads);
+        for (int i = 0; i < s.seq_len; i++) {
+#if INT8_OUTPUT
+            // 커널 WRITE_OUTPUT 과 같은 양자화 (fixed_t 행 -> quant_row_absmax)
+            fixed_t o_row[dv];
+            for (int v = 0; v < dv; v++) {
+                o_row[v] = (v < s.head_dim) ? (fixed_t)cpu_out[i][v] : (fixed_t)0;
+            }
+            qint8_t q_row[dv];
+            j.Output_scale[i] = quant_out_scale(quant_row_absmax<dv>(o_row, s.head_dim, q_row));
+            for (int v = 0; v < s.head_dim; v++) {
+                j.Output[i][v] = q_row[v];
+            }
+#else
+            for (int v = 0; v < s.head_dim; v++) {
+                j.Output[i][v] = (fixed_t)cpu_out[i][v];
+            }
+#endif
+        }
+    } else {
+        compute_attention_HLS(
+            qint8_view(const_cast<int8_t (*)[dk]>(j.Q)),
+            qint8_view(const_cast<int8_t (*)[dk]>(j.K)),
+            qint8_view(const_cast<int8_t (*)[dv]>(j.V)),
+            j.Output,
+            const_cast<float*>(j.scale_Q),
+            const_cast<float*>(j.scale_K),
+            const_cast<float*>(j.scale_V),
+#if INT8_OUTPUT
+            j.Output_scale,
+#endif
+#if BLOCK_SPARSE
+            block_ptr, block_idx,
+#endif
+            s.seq_len, s.head_dim, s.causal);
+    }
+
+    auto t_end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t_end - t_start).count();
+}
+
+void AttentionEngine::check_job(const char* what, const float* Output_scale) const {
+    if (!is_planned) {
+        fprintf(stderr, "AttentionEngine::%s called before plan\n", what);
+        exit(1);
+    }
+    if (INT8_OUTPUT && Output_scale == NULL) {
+        fprintf(stderr, "AttentionEngine::%s: INT8_OUTPUT build needs Output_scale\n", what);
+        exit(1);
+    }
+}
+
+double AttentionEngine::execute(
+    const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+    const float scale_Q[N], const float scale_K[N], const float scale_V[N],
+    out_t Output[N][dv], float Output_scale[N]
+) {
+    check_job("execute", Output_scale);
+    job j = { Q, K, V, scale_Q, scale_K, scale_V, Output, Output_scale, std::promise<double>() };
+    std::lock_guard<std::mutex> lock(run_mutex);
+    return run(j);
+}
+
+// --------------------------------------------------------
+// 비동기 - worker thread 는 첫 submit 때 시작
+// --------------------------------------------------------
+std::future<double> AttentionEngine::submit(
+    const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+    const float scale_Q[N], const float scale_K[N], const float scale_V[N],
+    out_t Output[N][dv], float Output_scale[N]
+) {
+    check_job("submit", Output_scale);
+
+    std::future<double> result;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back({ Q, K, V, scale_Q, scale_K, scale_V, Output, Output_scale, std::promise<double>() });
+        result = queue.back().done.get_future();
+        in_flight++;
+        if (!worker.joinable()) {
+            worker = std::thread(&AttentionEngine::worker_loop, this);
+        }
+    }
+    queue_cv.notify_one();
+    return result;
+}
+
+void AttentionEngine::drain() {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    idle_cv.wait(lock, [this] { return in_flight == 0; });
+}
+
+void AttentionEngine::worker_loop() {
+    for (;;) {
+        job j;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;      // stopping
+            j = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        double ms;
+        {
+            std::lock_guard<std::mutex> lock(run_mutex);
+            ms = run(j);
+        }
+        j.done.set_value(ms);
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            in_flight--;
+        }
+        idle_cv.notify_all();
+    }
+}
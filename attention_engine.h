@@ -0,0 +1,103 @@
+#pragma once
+#include "dcl_optimized.h"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// --------------------------------------------------------
+// AttentionEngine - host 라이브러리 API (attention_engine.cpp)
+// --------------------------------------------------------
+// plan()    : shape / backend 확정, scratch 버퍼 확보 (host_buffer pool) - 요청 전에 한 번
+// execute() : 동기 실행, 할당 없음 - 같은 plan 으로 반복 호출
+// submit()  : 비동기 실행 (engine worker thread 1개, FIFO), 다음 요청 준비와 겹치기용
+//
+// HLS kernel variant 는 링크한 top_flash_attention_<variant>.cpp 로 정해짐 -
+// plan 은 그 커널과 CPU backend (compute_attention_cpu) 중 하나를 고름
+// 커널 호출은 engine 안에서 직렬화 (DDR 카운터 / 장치 하나)
+
+struct attention_shape {
+    int seq_len;
+    int head_dim;
+    bool causal;
+};
+
+enum attention_backend {
+    ATTN_BACKEND_HLS,
+    ATTN_BACKEND_CPU,
+};
+
+struct attention_options {
+    attention_backend backend;
+    int cpu_threads;            // 0 = hardware_concurrency (cpu backend 만)
+};
+
+class AttentionEngine {
+public:
+    AttentionEngine();
+    ~AttentionEngine();
+
+    AttentionEngine(const AttentionEngine&) = delete;
+    AttentionEngine& operator=(const AttentionEngine&) = delete;
+
+    // shape 가 N / dk / dv 한도를 넘으면 false (이전 plan 유지)
+    // 다시 부르면 진행 중인 submit 이 끝난 뒤 새 shape 로 교체
+    bool plan(const attention_shape& shape, const attention_options& options);
+
+    // Output 은 [seq_len][head_dim] 만 씀. 반환값 = 커널 host wall-time (ms)
+    // INT8_OUTPUT 빌드는 Output_scale[seq_len] 필수 (dequant = Output * Output_scale), 아니면 무시
+    double execute(
+        const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+        const float scale_Q[N], const float scale_K[N], const float scale_V[N],
+        out_t Output[N][dv], float Output_scale[N] = NULL);
+
+    // 입력 / 출력 버퍼는 future 가 준비될 때까지 유지해야 함
+    std::future<double> submit(
+        const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+        const float scale_Q[N], const float scale_K[N], const float scale_V[N],
+        out_t Output[N][dv], float Output_scale[N] = NULL);
+
+    // submit 한 요청이 모두 끝날 때까지 대기
+    void drain();
+
+    bool planned() const { return is_planned; }
+    const attention_shape& shape() const { return plan_shape; }
+    const char* backend_name() const;
+
+private:
+    struct job {
+        const int8_t (*Q)[dk];
+        const int8_t (*K)[dk];
+        const int8_t (*V)[dv];
+        const float* scale_Q;
+        const float* scale_K;
+        const float* scale_V;
+        out_t (*Output)[dv];
+        float* Output_scale;
+        std::promise<double> done;
+    };
+
+    double run(const job& j);
+    void check_job(const char* what, const float* Output_scale) const;
+    void worker_loop();
+
+    bool is_planned;
+    attention_shape plan_shape;
+    attention_options plan_options;
+    float (*cpu_out)[dv];       // cpu backend float 출력 scratch
+#if BLOCK_SPARSE
+    // BLOCK_SPARSE 빌드의 커널 블록 목록 - engine 은 dense (causal 이면 대각까지), plan 때 생성
+    int block_ptr[SPARSE_Q_TILES + 1];
+    int block_idx[SPARSE_MAX_BLOCKS];
+#endif
+
+    std::mutex run_mutex;       // execute / worker 직렬화
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable idle_cv;
+    std::deque<job> queue;
+    int in_flight;
+    bool stopping;
+    std::thread worker;
+};
@@ -0,0 +1,353 @@
+// Kernel variant benchmark (bench/CMakeLists.txt 가 variant 마다 하나씩 빌드)
+// 소스: bench_attention.cpp host_common.cpp top_flash_attention_<variant>.cpp
+// 실행: ./bench_<variant> [--json=FILE] [--repeat=R] [--data-dir=DIR]
+//   - 입력 행렬: random seed x shape, 저장된 *_int8.bin / *_scales.bin, adversarial 큰 값 입력
+//   - 케이스마다 RMSE / max error / host wall-time / 모델링된 DDR 트래픽을 JSON 으로 출력
+#include "host_common.h"
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT "unknown"
+#endif
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "."
+#endif
+
+// random / file 케이스의 pass 기준 (host_optimized.cpp 의 TEST PASSED 와 같음)
+// adversarial 케이스는 기록만 하고 판정에서 제외
+#define BENCH_PASS_RMSE 0.1
+
+// --------------------------------------------------------
+// 입력 생성
+// --------------------------------------------------------
+enum InputKind {
+    INPUT_RANDOM,
+    INPUT_FILE,
+    INPUT_ADV_SATURATED,    // Q = K = +127, scale 큼 -> score 가 ap_fixed<32,16> 상한 근처
+    INPUT_ADV_INT8_MIN,     // Q = K = -128 -> dot 최대, score 가 ap_fixed<32,16> 범위 밖
+    INPUT_ADV_PEAKED,       // 한 key 만 큰 score, 나머지는 exp underflow
+    INPUT_ADV_ALT_SIGN,     // K 행 부호 교대 -> score +-큰 값, V 는 +-127
+};
+
+struct BenchCase {
+    const char* name;
+    InputKind kind;
+    unsigned seed;
+    int seq_len;
+    int head_dim;
+    bool causal;
+};
+
+static const BenchCase bench_cases[] = {
+    { "random",         INPUT_RANDOM,        1,    N,   dk, false },
+    { "random",         INPUT_RANDOM,        42,   N,   dk, false },
+    { "random",         INPUT_RANDOM,        1234, N,   dk, false },
+    { "random",         INPUT_RANDOM,        42,   17,  dk, false },
+    { "random",         INPUT_RANDOM,        42,   333, 48, false },
+    { "random",         INPUT_RANDOM,        7,    N,   dk, true  },
+    { "random",         INPUT_RANDOM,        42,   333, 48, true  },
+    { "file",           INPUT_FILE,          0,    N,   dk, false },
+    { "file",           INPUT_FILE,          0,    N,   dk, true  },
+    { "adv_saturated",  INPUT_ADV_SATURATED, 0,    N,   dk, false },
+    { "adv_int8_min",   INPUT_ADV_INT8_MIN,  0,    N,   dk, false },
+    { "adv_peaked",     INPUT_ADV_PEAKED,    3,    N,   dk, false },
+    { "adv_peaked",     INPUT_ADV_PEAKED,    3,    N,   dk, true  },
+    { "adv_alt_sign",   INPUT_ADV_ALT_SIGN,  0,    N,   dk, false },
+};
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static out_t Output_HLS[N][dv];
+static float Output_scale[N];       // INT8_OUTPUT 만 사용
+
+static string data_dir = BENCH_DATA_DIR;
+
+static bool file_exists(const string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f) fclose(f);
+    return f != NULL;
+}
+
+// 저장된 입력이 없으면 false (케이스는 skipped 로 기록)
+static bool generate_input(const BenchCase& bc) {
+    switch (bc.kind) {
+    case INPUT_FILE: {
+        string q = data_dir + "/Q_int8.bin";
+        if (!file_exists(q)) return false;
+        load_tensor_int8(q.c_str(), (int8_t*)Q_ref, N * dk);
+        load_tensor_int8((data_dir + "/K_int8.bin").c_str(), (int8_t*)K_ref, N * dk);
+        load_tensor_int8((data_dir + "/V_int8.bin").c_str(), (int8_t*)V_ref, N * dv);
+        load_scale((data_dir + "/Q_scales.bin").c_str(), Q_scale, N);
+        load_scale((data_dir + "/K_scales.bin").c_str(), K_scale, N);
+        load_scale((data_dir + "/V_scales.bin").c_str(), V_scale, N);
+        return true;
+    }
+    case INPUT_RANDOM:
+        // host_optimized.cpp 와 같은 분포
+        srand(bc.seed);
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+                K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+            }
+            Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+            K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+            V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        }
+        return true;
+    case INPUT_ADV_SATURATED:
+        // score = 64 * 127^2 * 0.5^2 / 8 ~= 32258 (ap_fixed<32,16> 상한 32768 바로 아래)
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[i][k] = 127;
+                K_ref[i][k] = 127;
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[i][v] = ((i + v) & 1) ? 127 : -127;
+            }
+            Q_scale[i] = 0.5f;
+            K_scale[i] = 0.5f;
+            V_scale[i] = 0.1f;     // |V| * scale_V < fixed_t 범위 (16)
+        }
+        return true;
+    case INPUT_ADV_INT8_MIN:
+        // (-128)^2 * 64 * 0.35^2 / 8 ~= 128450 -> score 가 ap_fixed<32,16> 범위를 넘음
+        // 홀수 K 행은 0 (score 0) 이라 overflow 가 나면 softmax 가 엉뚱한 key 를 고름
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[i][k] = -128;
+                K_ref[i][k] = (i & 1) ? 0 : -128;
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[i][v] = (i & 1) ? 127 : -128;
+            }
+            Q_scale[i] = 0.35f;
+            K_scale[i] = 0.35f;
+            V_scale[i] = 0.1f;
+        }
+        return true;
+    case INPUT_ADV_PEAKED:
+        // 37 행마다 Q 와 같은 부호의 K (score ~ +500), 나머지는 작은 random (score ~ 0)
+        srand(bc.seed);
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[i][k] = (k & 1) ? 127 : -127;
+                K_ref[i][k] = (i % 37 == 0) ? Q_ref[i][k] : (int8_t)(rand() % 9 - 4);
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+            }
+            Q_scale[i] = 0.06f;
+            K_scale[i] = 0.06f;
+            V_scale[i] = 0.1f;
+        }
+        return true;
+    case INPUT_ADV_ALT_SIGN:
+        // K 행 부호 교대 -> 한 행 안에서 score 가 +-2000, 절반은 exp 가 0 으로 underflow
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[i][k] = 127;
+                K_ref[i][k] = (i & 1) ? -127 : 127;
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[i][v] = (i & 2) ? 127 : -127;
+            }
+            Q_scale[i] = 0.125f;
+            K_scale[i] = 0.125f;
+            V_scale[i] = 0.1f;
+        }
+        return true;
+    }
+    return false;
+}
+
+// --------------------------------------------------------
+// 케이스 1회 실행 결과
+// --------------------------------------------------------
+struct BenchResult {
+    bool skipped;
+    double rmse;
+    double max_error;
+    double wall_ms;         // 커널 호출 host wall-time (repeat 중 최소)
+    double ref_ms;          // fp32 reference
+    int out_of_range_writes;
+    unsigned long long read_bytes;
+    unsigned long long write_bytes;
+    unsigned long long read_beats;
+    unsigned long long write_beats;
+};
+
+static BenchResult run_case(const BenchCase& bc, int repeat) {
+    BenchResult res;
+    memset(&res, 0, sizeof(res));
+    if (!generate_input(bc)) {
+        res.skipped = true;
+        return res;
+    }
+
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_hls[i][k] = Q_ref[i][k];
+            K_hls[i][k] = K_ref[i][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            V_hls[i][v] = V_ref[i][v];
+        }
+    }
+
+    auto r_start = chrono::steady_clock::now();
+    reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref,
+                             bc.seq_len, bc.head_dim, bc.causal);
+    auto r_end = chrono::steady_clock::now();
+    res.ref_ms = chrono::duration<double, milli>(r_end - r_start).count();
+
+    // DDR 카운터는 첫 실행 기준 (입력이 같으면 매번 동일)
+    res.wall_ms = 1e30;
+    for (int rep = 0; rep < repeat; rep++) {
+        memset(&ddr_stats, 0, sizeof(ddr_stats));
+        for (int i = 0; i < N; i++) {
+            for (int v = 0; v < dv; v++) {
+                Output_HLS[i][v] = 0;
+            }
+            Output_scale[i] = 0.0f;
+        }
+        auto t_start = chrono::steady_clock::now();
+        compute_attention_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                              Output_scale,
+#endif
+                              bc.seq_len, bc.head_dim, bc.causal);
+        auto t_end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(t_end - t_start).count();
+        if (ms < res.wall_ms) res.wall_ms = ms;
+        if (rep == 0) {
+            res.read_bytes = ddr_stats.read_bytes;
+            res.write_bytes = ddr_stats.write_bytes;
+            res.read_beats = ddr_stats.read_beats;
+            res.write_beats = ddr_stats.write_beats;
+        }
+    }
+
+    double mse = 0.0;
+    for (int i = 0; i < bc.seq_len; i++) {
+        for (int d = 0; d < bc.head_dim; d++) {
+#if INT8_OUTPUT
+            double out = Output_HLS[i][d].to_int() * (double)Output_scale[i];
+#else
+            double out = Output_HLS[i][d].to_double();
+#endif
+            double error = out - Output_ref[i][d];
+            mse += error * error;
+            if (fabs(error) > res.max_error) res.max_error = fabs(error);
+        }
+    }
+    res.rmse = sqrt(mse / (bc.seq_len * bc.head_dim));
+
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if ((i >= bc.seq_len || d >= bc.head_dim) && Output_HLS[i][d] != 0) {
+                res.out_of_range_writes++;
+            }
+        }
+        if (i >= bc.seq_len && Output_scale[i] != 0.0f) res.out_of_range_writes++;
+    }
+    return res;
+}
+
+// --------------------------------------------------------
+// Main - JSON 문서 하나 출력
+// --------------------------------------------------------
+int main(int argc, char** argv) {
+    const char* json_path = NULL;
+    int repeat = 1;
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--json=", 7) == 0) json_path = argv[a] + 7;
+        else if (strncmp(argv[a], "--repeat=", 9) == 0) repeat = atoi(argv[a] + 9);
+        else if (strncmp(argv[a], "--data-dir=", 11) == 0) data_dir = argv[a] + 11;
+        else {
+            fprintf(stderr, "Usage: %s [--json=FILE] [--repeat=R] [--data-dir=DIR]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (repeat < 1) repeat = 1;
+
+    FILE* out = json_path ? fopen(json_path, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", json_path);
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"variant\": \"%s\",\n", BENCH_VARIANT);
+    fprintf(out, "  \"config\": {\"N\": %d, \"dk\": %d, \"dv\": %d, \"Br\": %d, \"Bc\": %d, "
+                 "\"KV_RESIDENT_MAX\": %d, \"USE_FIXED_EXP\": %d, \"INT8_PV\": %d, \"INT8_OUTPUT\": %d, \"repeat\": %d},\n",
+            N, dk, dv, Br, Bc, KV_RESIDENT_MAX, USE_FIXED_EXP, INT8_PV, INT8_OUTPUT, repeat);
+    fprintf(out, "  \"cases\": [\n");
+
+    const int num_cases = sizeof(bench_cases) / sizeof(bench_cases[0]);
+    double worst_rmse = 0.0;
+    bool pass = true;
+
+    for (int t = 0; t < num_cases; t++) {
+        const BenchCase& bc = bench_cases[t];
+        BenchResult res = run_case(bc, repeat);
+        bool gated = (bc.kind == INPUT_RANDOM || bc.kind == INPUT_FILE);
+
+        fprintf(out, "    {\"input\": \"%s\", \"seed\": %u, \"seq_len\": %d, \"head_dim\": %d, "
+                     "\"causal\": %s, \"gated\": %s, ",
+                bc.name, bc.seed, bc.seq_len, bc.head_dim,
+                bc.causal ? "true" : "false", gated ? "true" : "false");
+        if (res.skipped) {
+            fprintf(out, "\"skipped\": true}");
+        } else {
+            fprintf(out, "\"skipped\": false, \"rmse\": %.8g, \"max_error\": %.8g, "
+                         "\"wall_ms\": %.3f, \"ref_ms\": %.3f, \"out_of_range_writes\": %d, "
+                         "\"ddr_read_bytes\": %llu, \"ddr_write_bytes\": %llu, "
+                         "\"ddr_read_beats\": %llu, \"ddr_write_beats\": %llu}",
+                    res.rmse, res.max_error, res.wall_ms, res.ref_ms, res.out_of_range_writes,
+                    res.read_bytes, res.write_bytes, res.read_beats, res.write_beats);
+            if (gated) {
+                if (res.rmse > worst_rmse) worst_rmse = res.rmse;
+                if (res.rmse >= BENCH_PASS_RMSE || res.out_of_range_writes != 0) pass = false;
+            }
+        }
+        fprintf(out, "%s\n", (t + 1 < num_cases) ? "," : "");
+
+        // 진행 상황은 stderr (stdout 은 JSON)
+        if (res.skipped) {
+            fprintf(stderr, "[%s] %-14s seq_len=%3d causal=%d  skipped (no input files in %s)\n",
+                    BENCH_VARIANT, bc.name, bc.seq_len, (int)bc.causal, data_dir.c_str());
+        } else {
+            fprintf(stderr, "[%s] %-14s seq_len=%3d causal=%d  rmse=%.6f max_err=%.6f wall=%.1f ms\n",
+                    BENCH_VARIANT, bc.name, bc.seq_len, (int)bc.causal,
+                    res.rmse, res.max_error, res.wall_ms);
+        }
+    }
+
+    fprintf(out, "  ],\n");
+    fprintf(out, "  \"worst_gated_rmse\": %.8g,\n", worst_rmse);
+    fprintf(out, "  \"pass\": %s\n", pass ? "true" : "false");
+    fprintf(out, "}\n");
+    if (json_path) fclose(out);
+
+    return pass ? 0 : 1;
+}
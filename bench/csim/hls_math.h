@@ -0,0 +1,14 @@
+#pragma once
+// --------------------------------------------------------
+// Vitis 없이 csim 빌드할 때만 쓰는 최소 hls_math.h (bench/CMakeLists.txt)
+// 커널이 실제로 부르는 hls::exp / hls::sqrt 만 std 로 연결
+// Vitis include 경로에 진짜 hls_math.h 가 있으면 이 파일은 include 되지 않음
+// --------------------------------------------------------
+#include <cmath>
+
+namespace hls {
+inline float  exp(float x)   { return std::exp(x); }
+inline double exp(double x)  { return std::exp(x); }
+inline float  sqrt(float x)  { return std::sqrt(x); }
+inline double sqrt(double x) { return std::sqrt(x); }
+}
@@ -0,0 +1,258 @@
+#include "cpu_attention.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_ATTN_X86 1
+#include <immintrin.h>
+#endif
+
+// --------------------------------------------------------
+// SIMD 커널 - int8 dot (int32 정확), int8 행 axpy (float)
+// n 은 head_dim, 벡터 폭으로 나누어 떨어지지 않는 꼬리는 scalar
+// --------------------------------------------------------
+static int32_t dot_i8_scalar(const int8_t* a, const int8_t* b, int n) {
+    int32_t sum = 0;
+    for (int k = 0; k < n; k++) {
+        sum += (int32_t)a[k] * (int32_t)b[k];
+    }
+    return sum;
+}
+
+// out[v] += w * x[v]
+static void axpy_i8_scalar(float* out, float w, const int8_t* x, int n) {
+    for (int v = 0; v < n; v++) {
+        out[v] += w * (float)x[v];
+    }
+}
+
+#ifdef CPU_ATTN_X86
+// int32 x8 수평 합
+__attribute__((target("avx2")))
+static inline int32_t hsum_i32_avx2(__m256i acc) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+// int8 -> int16 sign-extend 후 madd (pair 합이 int32 라 포화 없음)
+__attribute__((target("avx2")))
+static int32_t dot_i8_avx2(const int8_t* a, const int8_t* b, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a + k)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b + k)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    return hsum_i32_avx2(acc) + dot_i8_scalar(a + k, b + k, n - k);
+}
+
+__attribute__((target("avx2,fma")))
+static void axpy_i8_avx2(float* out, float w, const int8_t* x, int n) {
+    __m256 vw = _mm256_set1_ps(w);
+    int v = 0;
+    for (; v + 8 <= n; v += 8) {
+        __m256 vx = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(x + v))));
+        _mm256_storeu_ps(out + v, _mm256_fmadd_ps(vw, vx, _mm256_loadu_ps(out + v)));
+    }
+    axpy_i8_scalar(out + v, w, x + v, n - v);
+}
+
+// VNNI vpdpwssd: int16 pair 곱을 int32 accumulator 에 바로 누산
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+static int32_t dot_i8_vnni(const int8_t* a, const int8_t* b, int n) {
+    __m512i acc = _mm512_setzero_si512();
+    int k = 0;
+    for (; k + 32 <= n; k += 32) {
+        __m512i va = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(a + k)));
+        __m512i vb = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(b + k)));
+        acc = _mm512_dpwssd_epi32(acc, va, vb);
+    }
+    // 512 -> 256 으로 접고 AVX2 수평 합
+    // (gcc 헤더의 undefined pass-through 가 -Wuninitialized 를 내므로 reduce / cast 대신 maskz 형태)
+    __m256i half = _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xFF, acc, 0),
+                                    _mm512_maskz_extracti64x4_epi64(0xFF, acc, 1));
+    return hsum_i32_avx2(half) + dot_i8_avx2(a + k, b + k, n - k);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void axpy_i8_avx512(float* out, float w, const int8_t* x, int n) {
+    __m512 vw = _mm512_set1_ps(w);
+    int v = 0;
+    for (; v + 16 <= n; v += 16) {
+        __m512i xi = _mm512_maskz_cvtepi8_epi32(0xFFFF, _mm_loadu_si128((const __m128i*)(x + v)));
+        __m512 vx = _mm512_maskz_cvtepi32_ps(0xFFFF, xi);
+        _mm512_storeu_ps(out + v, _mm512_fmadd_ps(vw, vx, _mm512_loadu_ps(out + v)));
+    }
+    axpy_i8_avx2(out + v, w, x + v, n - v);
+}
+#endif
+
+// --------------------------------------------------------
+// 런타임 ISA 선택 (처음 한 번)
+// 환경변수 CPU_ATTN_ISA=scalar|avx2 로 낮은 경로 강제 가능 (비교 / 디버그용)
+// --------------------------------------------------------
+typedef int32_t (*dot_i8_fn)(const int8_t*, const int8_t*, int);
+typedef void (*axpy_i8_fn)(float*, float, const int8_t*, int);
+
+struct cpu_isa_t {
+    dot_i8_fn dot;
+    axpy_i8_fn axpy;
+    const char* name;
+};
+
+static cpu_isa_t select_isa() {
+    const char* force = getenv("CPU_ATTN_ISA");
+    if (force && strcmp(force, "scalar") == 0) {
+        return { dot_i8_scalar, axpy_i8_scalar, "scalar" };
+    }
+#ifdef CPU_ATTN_X86
+    __builtin_cpu_init();
+    bool allow_avx512 = !(force && strcmp(force, "avx2") == 0);
+    if (allow_avx512 && __builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512bw")) {
+        return { dot_i8_vnni, axpy_i8_avx512, "avx512-vnni" };
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return { dot_i8_avx2, axpy_i8_avx2, "avx2" };
+    }
+#endif
+    return { dot_i8_scalar, axpy_i8_scalar, "scalar" };
+}
+
+static const cpu_isa_t& cpu_isa() {
+    static const cpu_isa_t isa = select_isa();
+    return isa;
+}
+
+const char* cpu_attention_isa() {
+    return cpu_isa().name;
+}
+
+// --------------------------------------------------------
+// Q 타일 하나 (행 [i, i+Br)) - KV 블록 바깥, 행 안쪽 순서로 K/V 블록을 Br 행이 재사용
+// --------------------------------------------------------
+static void attention_q_tile(
+    const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+    float Output[N][dv],
+    const float scale_Q[N], const float scale_K[N], const float scale_V[N],
+    int i, int seq_len, int head_dim, bool causal, float attn_scale
+) {
+    const cpu_isa_t& isa = cpu_isa();
+    int rows = std::min(Br, seq_len - i);
+
+    float local_O[Br][dv];
+    float local_m[Br];
+    float local_l[Br];
+    for (int r = 0; r < rows; r++) {
+        local_m[r] = -INFINITY;
+        local_l[r] = 0.0f;
+        std::fill(local_O[r], local_O[r] + head_dim, 0.0f);
+    }
+
+    int kv_end = kv_range_end(i, seq_len, causal);
+
+    for (int j = 0; j < kv_end; j += Bc) {
+        int cols = std::min(Bc, seq_len - j);
+        bool diag_tile = is_diag_tile(i, j, causal);
+
+        for (int r = 0; r < rows; r++) {
+            float q_scale = scale_Q[i + r] * attn_scale;
+            float scores[Bc];
+            float row_max = -INFINITY;
+
+            // 1. Score (int8 dot -> per-row scale)
+            for (int c = 0; c < cols; c++) {
+                if (is_masked(i + r, j + c, seq_len, diag_tile)) {
+                    scores[c] = -INFINITY;
+                    continue;
+                }
+                int32_t dot = isa.dot(Q[i + r], K[j + c], head_dim);
+                scores[c] = (float)dot * q_scale * scale_K[j + c];
+                row_max = std::max(row_max, scores[c]);
+            }
+            if (row_max == -INFINITY) continue;     // 블록 전체 마스킹
+
+            // 2. Online softmax 갱신
+            float m_new = std::max(local_m[r], row_max);
+            float correction = std::exp(local_m[r] - m_new);
+            if (correction != 1.0f) {
+                for (int v = 0; v < head_dim; v++) {
+                    local_O[r][v] *= correction;
+                }
+            }
+
+            // 3. P * scale_V 를 가중치로 V 행 누산
+            float p_sum = 0.0f;
+            for (int c = 0; c < cols; c++) {
+                if (scores[c] == -INFINITY) continue;
+                float p = std::exp(scores[c] - m_new);
+                p_sum += p;
+                isa.axpy(local_O[r], p * scale_V[j + c], V[j + c], head_dim);
+            }
+
+            local_l[r] = local_l[r] * correction + p_sum;
+            local_m[r] = m_new;
+        }
+    }
+
+    for (int r = 0; r < rows; r++) {
+        float inv_sum = 1.0f / local_l[r];
+        for (int v = 0; v < head_dim; v++) {
+            Output[i + r][v] = local_O[r][v] * inv_sum;
+        }
+    }
+}
+
+// --------------------------------------------------------
+// Top - Q 타일을 스레드들이 atomic counter 로 나눠 가짐
+// --------------------------------------------------------
+void compute_attention_cpu(
+    const int8_t Q[N][dk],
+    const int8_t K[N][dk],
+    const int8_t V[N][dv],
+    float Output[N][dv],
+    const float scale_Q[N],
+    const float scale_K[N],
+    const float scale_V[N],
+    int seq_len,
+    int head_dim,
+    bool causal,
+    int num_threads
+) {
+    float attn_scale = 1.0f / std::sqrt((float)head_dim);
+    int num_tiles = (seq_len + Br - 1) / Br;
+
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+    }
+    num_threads = std::max(1, std::min(num_threads, num_tiles));
+
+    std::atomic<int> next_tile(0);
+    auto worker = [&]() {
+        for (int t = next_tile++; t < num_tiles; t = next_tile++) {
+            attention_q_tile(Q, K, V, Output, scale_Q, scale_K, scale_V,
+                             t * Br, seq_len, head_dim, causal, attn_scale);
+        }
+    };
+
+    if (num_threads == 1) {
+        worker();
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads - 1; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : threads) {
+        th.join();
+    }
+}
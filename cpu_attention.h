@@ -0,0 +1,29 @@
+#pragma once
+#include "dcl_optimized.h"
+
+// --------------------------------------------------------
+// CPU flash attention backend (cpu_attention.cpp)
+// --------------------------------------------------------
+// compute_attention_HLS 와 같은 int8 + per-row scale 입력, 같은 Br/Bc 타일 online softmax
+//   - int8 dot product: AVX-512 VNNI / AVX2 (런타임 CPU 검사), 그 외는 portable scalar
+//   - Q 타일 단위 멀티스레드 (타일끼리 독립)
+// FPGA 가 바쁠 때 fallback, testbench 에서는 scalar reference 대비 속도 비교용
+//
+// Output    : float (host 가 필요하면 fixed_t 로 변환)
+// num_threads: 0 이면 std::thread::hardware_concurrency()
+void compute_attention_cpu(
+    const int8_t Q[N][dk],
+    const int8_t K[N][dk],
+    const int8_t V[N][dv],
+    float Output[N][dv],
+    const float scale_Q[N],
+    const float scale_K[N],
+    const float scale_V[N],
+    int seq_len,
+    int head_dim,
+    bool causal,
+    int num_threads
+);
+
+// 선택된 SIMD 경로 이름 ("avx512-vnni", "avx2", "scalar")
+const char* cpu_attention_isa();
@@ -1,3 +1,4 @@
+#pragma once
 #include <stdio.h>
 #include <iostream>
 #include <fstream>
@@ -22,17 +23,459 @@ typedef ap_fixed<16, 5> fixed_t;
 // 중간 계산용 타입
 typedef ap_fixed<32, 16> calc_t;
 
+// 최대 크기 (m_axi depth / 로컬 버퍼 상한)
+// 실제 길이는 seq_len, head_dim 인자로 런타임에 지정
 #define N   512     
 #define dk  64     
 #define dv  64      
+// K/V 온칩 상주 용량 (행). seq_len <= KV_RESIDENT_MAX 이면 K/V 를 DDR 에서 한 번만 읽어
+// 모든 Q 타일이 재사용 (URAM). 초과하면 KV 블록 단위 스트리밍으로 fallback
+#ifndef KV_RESIDENT_MAX
+#define KV_RESIDENT_MAX N
+#endif
 
+// 출력 포맷 - INT8_OUTPUT=1 이면 Output 을 int8 + 행별 Output_scale[N] (float) 로 씀
+// 다음 layer (output projection) 가 int8 입력이라 write 대역폭 절반, host 재양자화 pass 없음
+// dequant: Output[i][v] * Output_scale[i]
+#ifndef INT8_OUTPUT
+#define INT8_OUTPUT 0
+#endif
+#if INT8_OUTPUT
+typedef qint8_t out_t;
+#else
+typedef fixed_t out_t;
+#endif
 
+// Block-sparse - BLOCK_SPARSE=1 이면 compute_attention_HLS 가 Q 타일별 active KV 블록 목록 (CSR) 을 받아
+// OUTER_KV_LOOP 가 목록의 블록만 돎 (local + global, strided 등 고정 sparse 패턴, 지연 = active 블록 수 비례)
+// DATAFLOW (= 템플릿 kernel) / typecasting_doublebuffer variant 만 지원
+#ifndef BLOCK_SPARSE
+#define BLOCK_SPARSE 0
+#endif
+#define SPARSE_Q_TILES    (N / Br)                  // CSR 행 수 상한
+#define SPARSE_MAX_BLOCKS ((N / Br) * (N / Bc))     // active 블록 수 상한 (dense)
+
+// m_axi 포트 원소 크기 (byte)
+#define QINT8_BYTES   1     // qint8_t
+#define SCALE_BYTES   4     // float scale
+#define OUTPUT_BYTES  2     // fixed_t (ap_fixed<16,5>), INT8_OUTPUT 이면 QINT8_BYTES + 행당 SCALE_BYTES
+#define ACT_BYTES     2     // fixed_t 활성값 입력 (quant variant)
+#define PARTIAL_BYTES 4     // calc_t (ap_fixed<32,16>) split-KV partial 출력 / 통계
+#define BLOCK_TABLE_BYTES 4 // int page index (paged KV)
+#define CU_SEQLENS_BYTES  4 // int 시퀀스 경계 offset (varlen batch)
+#define BLOCK_LIST_BYTES  4 // int block-sparse CSR 원소
+
+// KV260 HP 포트 128-bit 버스 - packed 포트 variant 에서 사용
+#define BUS_BITS          128
+#define BUS_PACK_FACTOR   16    // qint8_t lanes / beat (128 / 8)
+#define OUT_PACK_FACTOR   8     // fixed_t lanes / beat (128 / 16)
+#define DK_BEATS          (dk / BUS_PACK_FACTOR)
+#define DV_BEATS          (dv / BUS_PACK_FACTOR)
+#define DV_OUT_BEATS      (dv / OUT_PACK_FACTOR)
+typedef ap_uint<BUS_BITS> bus_t;
+
+// --------------------------------------------------------
+// csim 전용 DDR 트래픽 카운터 (정의는 host, 호출마다 host 가 reset)
+// thread 별 카운터 - 커널을 호출한 thread 에서 읽음 (split-KV 청크를 thread 로 동시에 돌려도 race 없음)
+// --------------------------------------------------------
+#ifndef __SYNTHESIS__
+struct ddr_stats_t {
+    unsigned long long read_bytes;
+    unsigned long long write_bytes;
+    unsigned long long read_beats;     // AXI data beat 수 (DDR_*_BEATS 를 세는 variant 만)
+    unsigned long long write_beats;
+};
+extern thread_local ddr_stats_t ddr_stats;
+#define DDR_READ(bytes)  (ddr_stats.read_bytes += (bytes))
+#define DDR_WRITE(bytes) (ddr_stats.write_bytes += (bytes))
+#define DDR_READ_BEATS(beats)  (ddr_stats.read_beats += (beats))
+#define DDR_WRITE_BEATS(beats) (ddr_stats.write_beats += (beats))
+#else
+#define DDR_READ(bytes)  ((void)0)
+#define DDR_WRITE(bytes) ((void)0)
+#define DDR_READ_BEATS(beats)  ((void)0)
+#define DDR_WRITE_BEATS(beats) ((void)0)
+#endif
+
+// --------------------------------------------------------
+// 마스킹 헬퍼 (모든 variant 공통)
+// --------------------------------------------------------
+// Q 타일 [i, i+Br) 가 봐야 하는 KV 범위의 끝
+// causal 이면 대각 블록에서 멈춤 (그 뒤 블록은 전부 마스킹이라 skip)
+// br / bc : 템플릿 kernel (flash_attention_tmpl.h) 의 타일 크기, 기본은 Br / Bc
+inline int kv_range_end(int i, int seq_len, bool causal, int br = Br) {
+    int diag_end = i + br;
+    return (causal && diag_end < seq_len) ? diag_end : seq_len;
+}
+
+// KV 타일 [j, j+Bc) 에 Q 타일 [i, i+Br) 기준 상삼각 원소가 있는지
+inline bool is_diag_tile(int i, int j, bool causal, int bc = Bc) {
+    return causal && (j + bc - 1 > i);
+}
+
+// score (q_idx, k_idx) 마스킹 여부 - seq_len 밖 열, 대각 타일 안의 상삼각
+inline bool is_masked(int q_idx, int k_idx, int seq_len, bool diag_tile) {
+    return (k_idx >= seq_len) || (diag_tile && k_idx > q_idx);
+}
+
+#if BLOCK_SPARSE
+// Block-sparse CSR 를 온칩으로 (Q 타일 [0, ceil(seq_len / br)) 만)
+// Q 타일 ib 의 active KV 블록 = blk_idx[blk_ptr[ib] .. blk_ptr[ib+1]), 블록 번호 jb 는 KV 행 [jb*Bc, jb*Bc + Bc)
+// 목록은 블록 번호 오름차순 (online softmax 누적 순서), causal 이면 대각 블록까지만 넣는 것이 host 책임
+// 대각 뒤 / seq_len 밖 블록이 들어와도 마스킹으로 결과는 같음 (계산만 낭비)
+// 블록 수는 MAX_BLOCKS 로 자르고 blk_ptr 은 [앞 원소, 블록 수] 로 잘라서 blk_idx 밖을 읽지 않음
+// BR_ / Q_TILES / MAX_BLOCKS : 템플릿 kernel (flash_attention_tmpl.h) 의 config, 기본은 Br / SPARSE_*
+template <int BR_ = Br, int Q_TILES = SPARSE_Q_TILES, int MAX_BLOCKS = SPARSE_MAX_BLOCKS>
+inline void load_block_list(
+    int kv_block_ptr[Q_TILES + 1],
+    int kv_block_idx[MAX_BLOCKS],
+    int seq_len,
+    int blk_ptr[Q_TILES + 1],
+    int blk_idx[MAX_BLOCKS]
+) {
+    int num_q_tiles = (seq_len + BR_ - 1) / BR_;
+
+    LOAD_BLOCK_PTR:
+    for (int t = 0; t <= Q_TILES; t++) {
+        #pragma HLS PIPELINE II=1
+        blk_ptr[t] = (t <= num_q_tiles) ? kv_block_ptr[t] : 0;
+        if (t <= num_q_tiles) DDR_READ(BLOCK_LIST_BYTES);
+    }
+
+    int num_blocks = blk_ptr[num_q_tiles];
+    if (num_blocks > MAX_BLOCKS) num_blocks = MAX_BLOCKS;
+    if (num_blocks < 0) num_blocks = 0;
+
+    // 잘린 블록 수 안으로, 감소하지 않게 (타일별 블록 수 >= 0)
+    int prev = 0;
+    CLAMP_BLOCK_PTR:
+    for (int t = 0; t <= Q_TILES; t++) {
+        #pragma HLS PIPELINE II=1
+        int p = blk_ptr[t];
+        if (p > num_blocks) p = num_blocks;
+        if (p < prev) p = prev;
+        blk_ptr[t] = p;
+        prev = p;
+    }
+
+    LOAD_BLOCK_IDX:
+    for (int n = 0; n < num_blocks; n++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_BLOCKS
+        #pragma HLS PIPELINE II=1
+        blk_idx[n] = kv_block_idx[n];
+        DDR_READ(BLOCK_LIST_BYTES);
+    }
+}
+#endif
+
+// fixed-point exp / reciprocal (USE_FIXED_EXP, EXP_LUT_BITS, RECIP_LUT_BITS)
+#include "softmax_fixed.h"
+// fixed_t 행 -> int8 + per-row scale (quant variant)
+#include "quant_fixed.h"
+
+
+// seq_len  : 유효 토큰 수 (1 <= seq_len <= N), 마지막 Br/Bc 타일은 마스킹
+// head_dim : 유효 head dim (1 <= head_dim <= dk, dv), 행 stride는 dk/dv 그대로
+// causal   : true 이면 k > q 위치 마스킹 (decoder), 대각 블록 이후 KV 블록은 skip
+// Output   : fixed_t, INT8_OUTPUT 이면 int8 + Output_scale (seq_len 밖 행은 쓰지 않음)
+// kv_block_ptr / kv_block_idx : BLOCK_SPARSE 빌드만 - Q 타일별 active KV 블록 CSR (load_block_list 참고)
+//                               active 블록이 없는 행의 출력은 0
 void compute_attention_HLS(
     qint8_t Q[N][dk],           
     qint8_t K[N][dk],           
     qint8_t V[N][dv],           
-    fixed_t Output[N][dv],     
+    out_t Output[N][dv],     
     float scale_Q[N],         
     float scale_K[N],          
-    float scale_V[N]           
+    float scale_V[N],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+#if BLOCK_SPARSE
+    int kv_block_ptr[SPARSE_Q_TILES + 1],
+    int kv_block_idx[SPARSE_MAX_BLOCKS],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal
+);
+
+
+// --------------------------------------------------------
+// Multi-head / batched entry (top_flash_attention_multihead.cpp)
+// --------------------------------------------------------
+// 최대 batch / head 수 (m_axi depth 용)
+#define MAX_BATCH   8
+#define MAX_HEADS   32
+
+// Q/Output, scale_Q : [batch * heads][N][dk]    (query head 인덱스 = b * heads + h)
+// K/V, scale_K/V     : [batch * kv_heads][N][dk] (KV head 인덱스 = b * kv_heads + h / group)
+// group = heads / kv_heads : MHA (kv_heads == heads), GQA, MQA (kv_heads == 1)
+// kv_heads <= 0 이거나 heads 가 kv_heads 의 배수가 아니면 아무것도 쓰지 않음
+// batch 가 [1, MAX_BATCH], heads 가 [1, MAX_HEADS] 밖이어도 아무것도 쓰지 않음
+// Output             : out_t, INT8_OUTPUT 이면 int8 + Output_scale [batch * heads][N]
+// 한 번의 호출로 layer 전체 head 처리, 다음 KV head 로드와 현재 group 계산을 overlap
+void compute_attention_batched_HLS(
+    qint8_t Q[][N][dk],
+    qint8_t K[][N][dk],
+    qint8_t V[][N][dv],
+    out_t Output[][N][dv],
+    float scale_Q[][N],
+    float scale_K[][N],
+    float scale_V[][N],
+#if INT8_OUTPUT
+    float Output_scale[][N],
+#endif
+    int batch,
+    int heads,
+    int kv_heads,
+    int seq_len,
+    int head_dim,
+    bool causal
+);
+
+
+// --------------------------------------------------------
+// Packed 128-bit 포트 entry (top_flash_attention_packed.cpp)
+// --------------------------------------------------------
+// Q/K/V  : [N][dk / BUS_PACK_FACTOR] beat, lane l = bits [8l+7 : 8l] = 열 (beat * 16 + l)
+// Output : [N][dv / OUT_PACK_FACTOR] beat, lane l = bits [16l+15 : 16l] = 열 (beat * 8 + l)
+// head_dim 밖 열은 무시 / 0 으로 씀 (마지막 beat 의 padding lane 포함)
+// Output 은 fixed_t 만 (INT8_OUTPUT 빌드는 top_flash_attention_packed.cpp 에서 #error)
+void compute_attention_packed_HLS(
+    bus_t Q[N][DK_BEATS],
+    bus_t K[N][DK_BEATS],
+    bus_t V[N][DV_BEATS],
+    bus_t Output[N][DV_OUT_BEATS],
+    float scale_Q[N],
+    float scale_K[N],
+    float scale_V[N],
+    int seq_len,
+    int head_dim,
+    bool causal
+);
+
+
+// --------------------------------------------------------
+// Fused 양자화 entry (top_flash_attention_quant.cpp)
+// --------------------------------------------------------
+// Q/K/V  : fixed_t 활성값 (Q_tensor.bin 등과 같은 ap_fixed<16,5>), offline 양자화 없이 바로 입력
+// LOAD_Q / LOAD_KV 에서 행마다 absmax -> int8 + scale (quant_row), 나머지는 DATAFLOW variant 와 동일
+// Output 은 fixed_t 만 (INT8_OUTPUT 빌드는 top_flash_attention_quant.cpp 에서 #error)
+void compute_attention_quant_HLS(
+    fixed_t Q[N][dk],
+    fixed_t K[N][dk],
+    fixed_t V[N][dv],
+    fixed_t Output[N][dv],
+    int seq_len,
+    int head_dim,
+    bool causal
+);
+
+
+// --------------------------------------------------------
+// Split-KV (flash-decoding) entry (top_flash_attention_splitkv.cpp)
+// --------------------------------------------------------
+// 최대 청크 수 (combine 포트 depth 용)
+#define MAX_KV_SPLITS 16
+
+// KV 범위 [kv_start, kv_end) 청크 하나 - Q 행 [q_start, q_start + q_len) 의 정규화 전 출력 + softmax 통계
+// Q 범위는 seq_len 안으로 잘림 (전체 = 0, seq_len / decode = seq_len - 1, 1), causal 마스킹은 절대 행 번호 기준
+// Partial_O : sum_k e^(s_k - m) * V_k (scale 적용),  Partial_m : 청크 안 max score,  Partial_l : sum_k e^(s_k - m)
+// 청크끼리 독립 - 청크마다 다른 compute unit 으로 dispatch, Bc 배수 경계면 KV 블록 경계가 단일 패스와 같음
+void compute_attention_splitkv_HLS(
+    qint8_t Q[N][dk],
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    float scale_Q[N],
+    float scale_K[N],
+    float scale_V[N],
+    calc_t Partial_O[N][dv],
+    calc_t Partial_m[N],
+    calc_t Partial_l[N],
+    int seq_len,
+    int head_dim,
+    bool causal,
+    int kv_start,
+    int kv_end,
+    int q_start,
+    int q_len
+);
+
+// 청크 partial [0, num_splits) 을 logsumexp 로 합쳐 compute_attention_HLS 와 같은 형식으로 출력
+// q_start / q_len 은 청크 커널과 같은 값 (범위 밖 행은 읽지도 쓰지도 않음)
+// num_splits 는 MAX_KV_SPLITS 로 잘림, 0 이하면 출력 없음
+void combine_splitkv_HLS(
+    calc_t Partial_O[MAX_KV_SPLITS][N][dv],
+    calc_t Partial_m[MAX_KV_SPLITS][N],
+    calc_t Partial_l[MAX_KV_SPLITS][N],
+    out_t Output[N][dv],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int num_splits,
+    int seq_len,
+    int head_dim,
+    int q_start,
+    int q_len
+);
+
+
+// --------------------------------------------------------
+// Paged KV cache entry (top_flash_attention_paged.cpp)
+// --------------------------------------------------------
+// page 하나 = KV 행 KV_PAGE_ROWS 개 (Bc 배수 - KV 타일이 page 경계를 넘지 않음)
+// pool 은 여러 시퀀스가 공유, 시퀀스마다 block table 로 자기 page 를 가리킴
+#ifndef KV_PAGE_ROWS
+#define KV_PAGE_ROWS Bc
+#endif
+#ifndef KV_POOL_PAGES
+#define KV_POOL_PAGES (4 * N / KV_PAGE_ROWS)
+#endif
+#define KV_MAX_PAGES (N / KV_PAGE_ROWS)     // 시퀀스 하나의 최대 page 수 (block table 길이)
+static_assert(KV_PAGE_ROWS % Bc == 0, "KV_PAGE_ROWS must be a multiple of Bc");
+static_assert(N % KV_PAGE_ROWS == 0, "KV_PAGE_ROWS must divide N");
+
+// K_pool/V_pool, scale_K/V_pool : [KV_POOL_PAGES][KV_PAGE_ROWS][...] page pool
+// block_table : 논리 page p (KV 행 [p * KV_PAGE_ROWS, (p+1) * KV_PAGE_ROWS)) 의 pool page index
+//               [0, ceil(seq_len / KV_PAGE_ROWS)) 만 읽음, [0, KV_POOL_PAGES) 밖의 index 는 page 0 으로 읽음
+// Q / Output 및 나머지 인자는 compute_attention_HLS 와 동일
+void compute_attention_paged_HLS(
+    qint8_t Q[N][dk],
+    qint8_t K_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dk],
+    qint8_t V_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dv],
+    out_t Output[N][dv],
+    float scale_Q[N],
+    float scale_K_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+    float scale_V_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int block_table[KV_MAX_PAGES],
+    int seq_len,
+    int head_dim,
+    bool causal
+);
+
+
+// --------------------------------------------------------
+// Incremental decode entry (top_flash_attention_decode.cpp)
+// --------------------------------------------------------
+// step 하나 = 새 토큰 1 개: k_new / v_new (+ scale) 를 cache 행 pos 에 append 하고
+// q_new 1 행으로 prefix [0, pos] attention (causal 행 pos 와 같은 결과)
+// K_cache / V_cache, scale_K/V_cache : 호출 사이에 유지되는 KV cache ([0, pos) 는 이전 step 들이 채움)
+// Output : 새 토큰 출력 1 행, INT8_OUTPUT 이면 int8 + Output_scale[0]
+// pos >= N 이면 (cache full) 아무것도 안 함
+void compute_attention_decode_HLS(
+    qint8_t q_new[dk],
+    qint8_t k_new[dk],
+    qint8_t v_new[dv],
+    float scale_q,
+    float scale_k,
+    float scale_v,
+    qint8_t K_cache[N][dk],
+    qint8_t V_cache[N][dv],
+    float scale_K_cache[N],
+    float scale_V_cache[N],
+    out_t Output[dv],
+#if INT8_OUTPUT
+    float Output_scale[1],
+#endif
+    int pos,
+    int head_dim
+);
+
+
+// --------------------------------------------------------
+// Ragged (variable-length) batch entry (top_flash_attention_varlen.cpp)
+// --------------------------------------------------------
+// flat 토큰 버퍼 상한 (m_axi depth 용) - 시퀀스 MAX_BATCH 개 x 최대 N 토큰
+#define MAX_VARLEN_TOKENS (MAX_BATCH * N)
+
+// Q/K/V/Output, scale : padding 없이 시퀀스를 이어 붙인 [total_tokens][...] (total_tokens = cu_seqlens[batch])
+// cu_seqlens : 시퀀스 b 의 토큰 범위 [cu_seqlens[b], cu_seqlens[b+1]), cu_seqlens[0] = 0, 길이는 1..N
+// 시퀀스끼리 attention 없음, causal 은 시퀀스 안 위치 기준
+// 시퀀스 밖 토큰 (cu_seqlens[batch] 이후) 의 Output 은 쓰지 않음
+// cu_seqlens[b] 가 [0, MAX_VARLEN_TOKENS) 밖이거나 cu_seqlens[b + 1] <= cu_seqlens[b] 인 시퀀스는 skip,
+// MAX_VARLEN_TOKENS 를 넘는 끝은 잘림 (flat 버퍼 밖은 읽지도 쓰지도 않음)
+void compute_attention_varlen_HLS(
+    qint8_t Q[MAX_VARLEN_TOKENS][dk],
+    qint8_t K[MAX_VARLEN_TOKENS][dk],
+    qint8_t V[MAX_VARLEN_TOKENS][dv],
+    out_t Output[MAX_VARLEN_TOKENS][dv],
+    float scale_Q[MAX_VARLEN_TOKENS],
+    float scale_K[MAX_VARLEN_TOKENS],
+    float scale_V[MAX_VARLEN_TOKENS],
+#if INT8_OUTPUT
+    float Output_scale[MAX_VARLEN_TOKENS],
+#endif
+    int cu_seqlens[MAX_BATCH + 1],
+    int batch,
+    int head_dim,
+    bool causal
+);
+
+
+// --------------------------------------------------------
+// Sliding-window entry (top_flash_attention_window.cpp)
+// --------------------------------------------------------
+// window > 0 : 행 q 는 최근 키 (q - window, q] 만 봄 (lookback) - causal 이어야 함, causal = false 면 아무것도 안 씀
+//              Q 타일 [i, i+Br) 는 KV 블록 [i - window, i + Br) 안만 돎
+// window <= 0: window 없음 (compute_attention_HLS 와 같은 범위, causal 인자 그대로)
+// KV ring : 연속한 Q 타일의 window 는 대부분 겹침 - 새로 들어오는 KV 블록만 DDR 에서 읽고 나머지는 ring 에서 재사용
+//           ring 은 KV_RESIDENT_MAX 행 이상 - seq_len <= KV_RESIDENT_MAX 면 시퀀스 전체가 들어감 (상주 모드, 블록당 한 번)
+//           더 긴 시퀀스는 WINDOW_MAX 이하 window 만 ring, 더 큰 window 는 Q 타일마다 window 범위만 DDR 에서 다시 읽음
+//           어느 경우든 K/V DDR 읽기는 같은 seq_len 의 compute_attention_HLS 이하
+#ifndef WINDOW_MAX
+#define WINDOW_MAX 256
+#endif
+// window 하나 (Q 타일 [i, i+Br) -> KV [i - window + 1, i + Br)) 가 걸치는 최대 KV 블록 수
+#define KV_WINDOW_BLOCKS ((WINDOW_MAX + Br - 2 + Bc - 1) / Bc + 1)
+#define KV_RING_BLOCKS ((KV_WINDOW_BLOCKS > KV_RESIDENT_MAX / Bc) ? KV_WINDOW_BLOCKS : KV_RESIDENT_MAX / Bc)
+#define KV_RING_ROWS (KV_RING_BLOCKS * Bc)
+
+// Q 타일 [i, i+Br) 의 window 가 걸치는 최대 KV 블록 수 (ring 에 들어가는지 판단)
+inline int kv_window_blocks(int window, int br = Br, int bc = Bc) {
+    return (window + br - 2 + bc - 1) / bc + 1;
+}
+
+// KV ring 사용 여부 - 시퀀스 전체 (상주) 또는 window 가 ring 에 들어감
+inline bool kv_window_use_ring(int seq_len, int window) {
+    return (seq_len + Bc - 1) / Bc <= KV_RING_BLOCKS ||
+           (window > 0 && kv_window_blocks(window) <= KV_RING_BLOCKS);
+}
+
+// Q 타일 [i, i+Br) 의 window KV 시작 - Bc 경계로 내림 (끝은 causal 과 같은 kv_range_end)
+inline int kv_window_start(int i, int window, int bc = Bc) {
+    int first = i - window + 1;
+    return (window > 0 && first > 0) ? first / bc * bc : 0;
+}
+
+// KV 타일 [j, j+Bc) 에 Q 타일 [i, i+Br) 기준 window 밖 (q - k >= window) 원소가 있는지
+inline bool is_window_edge_tile(int i, int j, int window, int br = Br) {
+    return window > 0 && (i + br - 1) - j >= window;
+}
+
+// is_masked + window 가장자리 타일 안의 window 밖 원소
+inline bool is_masked_window(int q_idx, int k_idx, int seq_len, bool diag_tile, bool edge_tile, int window) {
+    return is_masked(q_idx, k_idx, seq_len, diag_tile) || (edge_tile && q_idx - k_idx >= window);
+}
+
+// window : 위 정의, 나머지 인자는 compute_attention_HLS 와 동일
+// 비용 O(seq_len * window), ring 을 쓰면 K/V 는 DDR 에서 한 번만 읽음
+void compute_attention_window_HLS(
+    qint8_t Q[N][dk],
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    out_t Output[N][dv],
+    float scale_Q[N],
+    float scale_K[N],
+    float scale_V[N],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal,
+    int window
 );
@@ -0,0 +1,710 @@
+#pragma once
+#include "dcl_optimized.h"
+
+// --------------------------------------------------------
+// 템플릿 kernel - shape / 타일 크기 / 수치 타입을 컴파일 타임 파라미터로
+// (top_flash_attention_template.cpp 에서 explicit instantiation + HLS top wrapper)
+// --------------------------------------------------------
+// K/V 상주, Q 타일 3-stage DATAFLOW, row engine, block-sparse (BLOCK_SPARSE) datapath 의 유일한 구현
+// DATAFLOW variant (top_flash_attention_DATAFLOW.cpp) 는 attn_cfg_default instantiation 의 HLS top
+// 다른 variant (paged / quant / splitkv / varlen / window / multihead / packed) 도 attn_cfg_default 의
+// process_task_tmpl / compute_q_tile_tmpl 을 쓰고 KV source (아래) 로 자기 KV 로더와 루프 범위만 넘김
+// decode variant 는 같은 datapath 의 BR = 1 config (attn_cfg_decode)
+// 배열 크기 / partition / tripcount 가 전부 config 상수라 config 마다 따로 특수화된 datapath
+// softmax scale 1/sqrt(DK) 는 컴파일 타임 상수, head_dim < DK 인 호출만 런타임 sqrt
+// N / dk / dv / Br / Bc 는 매크로라 템플릿 파라미터 이름은 NMAX_ / DK_ / DV_ / BR_ / BC_
+
+// PROCESS_ROW 병렬 row engine 수 (BR 의 약수). engine 당 SCORE_DOT / WEIGHTED_SUM MAC 배열 1 벌
+// DSP 예산에 맞춰 -DNUM_ROW_ENGINES=2/4/8 로 지정
+#ifndef NUM_ROW_ENGINES
+#define NUM_ROW_ENGINES 1
+#endif
+
+// 컴파일 타임 sqrt (Newton, constexpr) - hls::sqrt 는 constexpr 이 아님
+constexpr double attn_ct_sqrt_iter(double x, double g, int n) {
+    return (n == 0) ? g : attn_ct_sqrt_iter(x, 0.5 * (g + x / g), n - 1);
+}
+constexpr double attn_ct_sqrt(double x) {
+    return attn_ct_sqrt_iter(x, (x > 1.0) ? x : 1.0, 32);
+}
+
+template <int NMAX_, int DK_, int DV_, int BR_, int BC_,
+          typename CALC_T = calc_t, typename SCALE_T = scale_fixed_t, typename FIXED_T = fixed_t>
+struct attn_config {
+    static const int NMAX = NMAX_;
+    static const int DK   = DK_;
+    static const int DV   = DV_;
+    static const int BR   = BR_;
+    static const int BC   = BC_;
+    // K/V 상주 용량 (행) - KV_RESIDENT_MAX 와 NMAX 중 작은 쪽
+    static const int KV_RES = (KV_RESIDENT_MAX < NMAX_) ? KV_RESIDENT_MAX : NMAX_;
+    // PROCESS_ROW row engine 수 - NUM_ROW_ENGINES 와 BR 중 작은 쪽 (BR = 1 decode 는 engine 1 개)
+    static const int ROW_ENGINES = (NUM_ROW_ENGINES < BR_) ? NUM_ROW_ENGINES : BR_;
+
+    // block-sparse CSR 크기 (SPARSE_Q_TILES / SPARSE_MAX_BLOCKS 의 config 버전)
+    static const int SPARSE_TILES  = NMAX_ / BR_;
+    static const int SPARSE_BLOCKS = (NMAX_ / BR_) * (NMAX_ / BC_);
+
+    typedef CALC_T  calc_type;      // score / softmax 통계 / 출력 누산 (attn_exp / attn_recip 도 이 타입)
+    typedef SCALE_T scale_type;     // per-row scale
+    typedef FIXED_T fixed_type;     // 정규화된 출력 (INT8_OUTPUT 이면 양자화 입력)
+    static const int OUT_BYTES = (FIXED_T::width + 7) / 8;     // fixed 출력 원소 byte (DDR 카운터)
+#if INT8_OUTPUT
+    typedef qint8_t out_type;       // Output 포트 (+ Output_scale)
+#else
+    typedef FIXED_T out_type;
+#endif
+
+    // head_dim == DK 일 때 softmax scale
+    static constexpr double attn_scale() { return 1.0 / attn_ct_sqrt((double)DK_); }
+
+    static_assert(BR_ % ROW_ENGINES == 0, "NUM_ROW_ENGINES must divide BR");
+    static_assert(NMAX_ % BR_ == 0 && NMAX_ % BC_ == 0, "NMAX must be a multiple of BR and BC");
+    static_assert(CALC_T::iwidth >= 15, "calc type must hold the -10000 mask score");
+};
+
+// 기본 설정 (dcl_optimized.h 매크로) - compute_attention_HLS 와 같은 shape
+typedef attn_config<N, dk, dv, Br, Bc> attn_cfg_default;
+// decode (새 토큰 q 1 행) - Q 타일 1 행, KV 블록은 기본과 같은 Bc
+typedef attn_config<N, dk, dv, 1, Bc> attn_cfg_decode;
+
+// explicit instantiation 대상 (top_flash_attention_template.cpp)
+typedef attn_config<N, 64,  64,  16, 16> attn_cfg_d64_b16;
+typedef attn_config<N, 64,  64,  32, 32> attn_cfg_d64_b32;
+typedef attn_config<N, 64,  64,  64, 64> attn_cfg_d64_b64;
+typedef attn_config<N, 128, 128, 16, 16> attn_cfg_d128_b16;
+typedef attn_config<N, 128, 128, 32, 32> attn_cfg_d128_b32;
+typedef attn_config<N, 128, 128, 64, 64> attn_cfg_d128_b64;
+// 넓은 수치 타입 (누산 Q16.24, 출력 Q8.16) - 기본 타입과 정확도 비교용
+typedef attn_config<N, 64,  64,  32, 32, ap_fixed<40,16>, scale_fixed_t, ap_fixed<24,8> > attn_cfg_d64_b32_wide;
+
+
+// K/V 상주 로드 - 전체 K, V 를 DDR 에서 한 번만 읽어서 온칩(URAM) 버퍼에 저장
+template <class CFG>
+void load_kv_resident_tmpl(
+    qint8_t K[CFG::NMAX][CFG::DK],
+    qint8_t V[CFG::NMAX][CFG::DV],
+    float scale_K[CFG::NMAX],
+    float scale_V[CFG::NMAX],
+    int seq_len,
+    int head_dim,
+    qint8_t res_K[CFG::KV_RES][CFG::DK],
+    qint8_t res_V[CFG::KV_RES][CFG::DV],
+    typename CFG::scale_type res_scale_K[CFG::KV_RES],
+    typename CFG::scale_type res_scale_V[CFG::KV_RES]
+) {
+    #pragma HLS INLINE off
+    typedef typename CFG::scale_type scale_type;
+
+    LOAD_KV_RESIDENT:
+    for (int c = 0; c < seq_len; c++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=CFG::KV_RES
+        #pragma HLS PIPELINE II=1
+        res_scale_K[c] = (scale_type)scale_K[c];
+        res_scale_V[c] = (scale_type)scale_V[c];
+        for (int k = 0; k < CFG::DK; k++) {
+            res_K[c][k] = (k < head_dim) ? K[c][k] : (qint8_t)0;
+        }
+        for (int v = 0; v < CFG::DV; v++) {
+            res_V[c][v] = (v < head_dim) ? V[c][v] : (qint8_t)0;
+        }
+        DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// Load KV - K, V 블록을 PIPO 버퍼에 바로 씀 (상주 모드면 온칩, 아니면 DDR)
+template <class CFG>
+void load_kv_task_tmpl(
+    qint8_t K[CFG::NMAX][CFG::DK],
+    qint8_t V[CFG::NMAX][CFG::DV],
+    float scale_K[CFG::NMAX],
+    float scale_V[CFG::NMAX],
+    qint8_t res_K[CFG::KV_RES][CFG::DK],
+    qint8_t res_V[CFG::KV_RES][CFG::DV],
+    typename CFG::scale_type res_scale_K[CFG::KV_RES],
+    typename CFG::scale_type res_scale_V[CFG::KV_RES],
+    bool kv_resident,
+    int j,
+    int seq_len,
+    int head_dim,
+    qint8_t kv_K[CFG::BC][CFG::DK],
+    qint8_t kv_V[CFG::BC][CFG::DV],
+    typename CFG::scale_type kv_scale_K[CFG::BC],
+    typename CFG::scale_type kv_scale_V[CFG::BC]
+) {
+    #pragma HLS INLINE off
+    typedef typename CFG::scale_type scale_type;
+
+    // seq_len 밖의 행, head_dim 밖의 열은 0
+    LOAD_KV:
+    for (int c = 0; c < CFG::BC; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        bool row_valid = (kv_row < seq_len);
+        kv_scale_K[c] = !row_valid ? (scale_type)0 : kv_resident ? res_scale_K[kv_row] : (scale_type)scale_K[kv_row];
+        kv_scale_V[c] = !row_valid ? (scale_type)0 : kv_resident ? res_scale_V[kv_row] : (scale_type)scale_V[kv_row];
+        for (int k = 0; k < CFG::DK; k++) {
+            kv_K[c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : kv_resident ? res_K[kv_row][k] : K[kv_row][k];
+        }
+        for (int v = 0; v < CFG::DV; v++) {
+            kv_V[c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : kv_resident ? res_V[kv_row][v] : V[kv_row][v];
+        }
+        if (row_valid && !kv_resident) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// KV 타일 [j, j+BC) 하나의 마스크 - process_task_tmpl 은 이것만 봄 (경계 / 대각 / window 는 KV source 가 결정)
+struct attn_tile_mask {
+    int  kv_end;        // 이 열부터 마스킹 (seq_len, split-KV 면 청크 끝)
+    bool diag_tile;     // 대각 타일 - 상삼각 마스킹
+    bool edge_tile;     // window 가장자리 타일 - window 밖 (q - k >= window) 마스킹
+    int  window;
+};
+
+// seq_len (kv_end) 경계 + causal 대각만 있는 타일 (window 없음)
+inline attn_tile_mask attn_causal_mask(int kv_end, bool diag_tile) {
+    attn_tile_mask m = { kv_end, diag_tile, false, 0 };
+    return m;
+}
+
+// edge_tile == false 면 is_masked 와 같음
+inline bool attn_masked(const attn_tile_mask& m, int q_idx, int k_idx) {
+    return is_masked_window(q_idx, k_idx, m.kv_end, m.diag_tile, m.edge_tile, m.window);
+}
+
+// Process - PIPO 버퍼에서 바로 attention 계산, CFG::ROW_ENGINES 개 행 동시 처리
+// 모든 variant 공통 datapath (variant 는 KV 로더와 mask 만 다름)
+template <class CFG>
+void process_task_tmpl(
+    qint8_t local_K[CFG::BC][CFG::DK],
+    qint8_t local_V[CFG::BC][CFG::DV],
+    typename CFG::scale_type local_scale_K[CFG::BC],
+    typename CFG::scale_type local_scale_V[CFG::BC],
+    qint8_t local_Q[CFG::BR][CFG::DK],
+    typename CFG::scale_type local_scale_Q[CFG::BR],
+    typename CFG::calc_type local_O[CFG::BR][CFG::DV],
+    typename CFG::calc_type local_m[CFG::BR],
+    typename CFG::calc_type local_l[CFG::BR],
+    int i,
+    int j,
+    attn_tile_mask mask,
+    typename CFG::scale_type attn_scale
+) {
+    #pragma HLS INLINE off
+    typedef typename CFG::calc_type calc_type;
+
+    PROCESS_ROW:
+    for (int r0 = 0; r0 < CFG::BR; r0 += CFG::ROW_ENGINES) {
+
+        calc_type scores[CFG::ROW_ENGINES][CFG::BC];
+        #pragma HLS ARRAY_PARTITION variable=scores complete dim=0
+        calc_type row_max_val[CFG::ROW_ENGINES];
+        #pragma HLS ARRAY_PARTITION variable=row_max_val complete
+
+        for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+            #pragma HLS UNROLL
+            row_max_val[e] = -10000.0;
+        }
+
+        SCORE_LOOP:
+        for (int c = 0; c < CFG::BC; c++) {
+            #pragma HLS PIPELINE II=1
+
+            SCORE_ENGINES:
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                int r = r0 + e;
+                qint32_t score_sum_int = 0;
+
+                SCORE_DOT:
+                for (int k = 0; k < CFG::DK; k++) {
+                    #pragma HLS UNROLL factor=4
+                    score_sum_int += local_Q[r][k] * local_K[c][k];
+                }
+
+                auto combined_scale = local_scale_Q[r] * local_scale_K[c];
+                auto raw_score = score_sum_int * combined_scale;
+                scores[e][c] = (calc_type)(raw_score * attn_scale);
+
+                // kv_end 밖 열, 대각 타일의 상삼각, window 밖은 마스킹
+                if (attn_masked(mask, i + r, j + c)) {
+                    scores[e][c] = -10000.0;
+                }
+
+                if (scores[e][c] > row_max_val[e]) {
+                    row_max_val[e] = scores[e][c];
+                }
+            }
+        }
+
+        calc_type m_new[CFG::ROW_ENGINES];
+        #pragma HLS ARRAY_PARTITION variable=m_new complete
+        calc_type correction_prev[CFG::ROW_ENGINES];
+        #pragma HLS ARRAY_PARTITION variable=correction_prev complete
+        calc_type p_sum_curr[CFG::ROW_ENGINES];
+        #pragma HLS ARRAY_PARTITION variable=p_sum_curr complete
+
+        for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+            #pragma HLS UNROLL
+            calc_type m_prev = local_m[r0 + e];
+            m_new[e] = (m_prev > row_max_val[e]) ? m_prev : row_max_val[e];
+            correction_prev[e] = attn_exp<calc_type>(m_prev - m_new[e]);
+            p_sum_curr[e] = 0;
+        }
+
+        calc_type P[CFG::ROW_ENGINES][CFG::BC];
+        #pragma HLS ARRAY_PARTITION variable=P complete dim=0
+
+        SOFTMAX_LOOP:
+        for (int c = 0; c < CFG::BC; c++) {
+            #pragma HLS PIPELINE II=1
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                P[e][c] = !attn_masked(mask, i + r0 + e, j + c) ? attn_exp<calc_type>(scores[e][c] - m_new[e]) : (calc_type)0;
+                p_sum_curr[e] += P[e][c];
+            }
+        }
+
+        calc_type scaled_P[CFG::ROW_ENGINES][CFG::BC];
+        #pragma HLS ARRAY_PARTITION variable=scaled_P complete dim=0
+
+        PRE_SCALE_LOOP:
+        for (int c = 0; c < CFG::BC; c++) {
+            #pragma HLS PIPELINE II=1
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                scaled_P[e][c] = P[e][c] * local_scale_V[c];
+            }
+        }
+
+#if INT8_PV
+        // P * scale_V -> uint8 (row 별 2^pv_shift step), OUTPUT_UPDATE 는 int8 x int8 -> int32 MAC
+        calc_type p_max[CFG::ROW_ENGINES];
+        #pragma HLS ARRAY_PARTITION variable=p_max complete
+        for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+            #pragma HLS UNROLL
+            p_max[e] = 0;
+        }
+        PV_MAX_LOOP:
+        for (int c = 0; c < CFG::BC; c++) {
+            #pragma HLS PIPELINE II=1
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                if (scaled_P[e][c] > p_max[e]) p_max[e] = scaled_P[e][c];
+            }
+        }
+        int pv_shift[CFG::ROW_ENGINES];
+        #pragma HLS ARRAY_PARTITION variable=pv_shift complete
+        for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+            #pragma HLS UNROLL
+            pv_shift[e] = pv_quant_shift<calc_type>(p_max[e]);
+        }
+
+        ap_uint<8> q_P[CFG::ROW_ENGINES][CFG::BC];
+        #pragma HLS ARRAY_PARTITION variable=q_P complete dim=0
+        PV_QUANT_LOOP:
+        for (int c = 0; c < CFG::BC; c++) {
+            #pragma HLS PIPELINE II=1
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                q_P[e][c] = pv_quant<calc_type>(scaled_P[e][c], pv_shift[e]);
+            }
+        }
+#endif
+
+        for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+            #pragma HLS UNROLL
+            local_l[r0 + e] = local_l[r0 + e] * correction_prev[e] + p_sum_curr[e];
+            local_m[r0 + e] = m_new[e];
+        }
+
+#if INT8_PV
+        OUTPUT_UPDATE:
+        for (int v = 0; v < CFG::DV; v++) {
+            #pragma HLS PIPELINE II=1
+
+            OUTPUT_ENGINES:
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                qint32_t pv_acc = 0;
+
+                WEIGHTED_SUM:
+                for (int c = 0; c < CFG::BC; c++) {
+                    #pragma HLS UNROLL factor=4
+                    pv_acc += q_P[e][c] * local_V[c][v];
+                }
+                local_O[r0 + e][v] = local_O[r0 + e][v] * correction_prev[e] + pv_dequant<calc_type>(pv_acc, pv_shift[e]);
+            }
+        }
+#else
+        OUTPUT_UPDATE:
+        for (int v = 0; v < CFG::DV; v++) {
+            #pragma HLS PIPELINE II=1
+
+            OUTPUT_ENGINES:
+            for (int e = 0; e < CFG::ROW_ENGINES; e++) {
+                #pragma HLS UNROLL
+                calc_type weighted_sum = 0;
+
+                WEIGHTED_SUM:
+                for (int c = 0; c < CFG::BC; c++) {
+                    #pragma HLS UNROLL factor=4
+                    auto term = scaled_P[e][c] * local_V[c][v];
+                    weighted_sum += term;
+                }
+                local_O[r0 + e][v] = local_O[r0 + e][v] * correction_prev[e] + weighted_sum;
+            }
+        }
+#endif
+    }
+}
+
+
+// --------------------------------------------------------
+// Q 타일 단위 3-stage DATAFLOW:  load_q_task(i+1) | compute_q_tile(i) | write_output_task(i-1)
+// --------------------------------------------------------
+
+// Load Q - Q 타일과 scale 을 DDR 에서 읽음 (seq_len 밖의 행, head_dim 밖의 열은 0)
+template <class CFG>
+void load_q_task_tmpl(
+    qint8_t Q[CFG::NMAX][CFG::DK],
+    float scale_Q[CFG::NMAX],
+    int i,
+    int seq_len,
+    int head_dim,
+    qint8_t tile_Q[CFG::BR][CFG::DK],
+    typename CFG::scale_type tile_scale_Q[CFG::BR]
+) {
+    #pragma HLS INLINE off
+    typedef typename CFG::scale_type scale_type;
+
+    LOAD_Q:
+    for (int r = 0; r < CFG::BR; r++) {
+        #pragma HLS PIPELINE II=1
+        bool row_valid = (i + r < seq_len);
+        tile_scale_Q[r] = row_valid ? (scale_type)scale_Q[i + r] : (scale_type)0;
+        if (row_valid) DDR_READ(head_dim * QINT8_BYTES + SCALE_BYTES);
+        for (int k = 0; k < CFG::DK; k++) {
+            tile_Q[r][k] = (row_valid && k < head_dim) ? Q[i + r][k] : (qint8_t)0;
+        }
+    }
+}
+
+// --------------------------------------------------------
+// KV source - variant 마다 다른 부분 (KV 로더, KV 블록 루프 범위, 타일 마스크) 만 담은 functor
+// accumulate_q_tile_tmpl 의 OUTER_KV_LOOP 가 부름:
+//   MAX_BLOCKS / KV_PARTITION          : OUTER_KV_LOOP tripcount 상한 / kv_K, kv_V dim 2 partition
+//   first_block(i) / end_block(i)      : Q 타일 [i, i+BR) 의 KV 블록 루프 [first, end)
+//   block_row(i, jb)                   : 블록 jb 의 첫 KV 행 j (mask / process 기준 좌표)
+//   tile_mask(i, j)                    : KV 타일 [j, j+BC) 의 attn_tile_mask
+//   load(i, jb, j, kv_K, kv_V, ...)    : KV 타일을 PIPO 버퍼로 - variant 의 INLINE off 로더 호출
+// 멤버는 포트 / 온칩 버퍼 포인터 (배열 인자와 같은 decay 형) 와 스칼라 인자, 메서드는 전부 inline (DATAFLOW task 는 로더 + process_task_tmpl)
+// --------------------------------------------------------
+
+// 기본 source - K/V 상주 또는 DDR 스트리밍 (load_kv_task_tmpl), BLOCK_SPARSE 면 active 블록 목록만
+template <class CFG>
+struct attn_kv_source {
+    typedef typename CFG::scale_type scale_type;
+    static const int MAX_BLOCKS   = CFG::NMAX / CFG::BC;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*K)[CFG::DK];          // [NMAX][DK] 포트
+    qint8_t (*V)[CFG::DV];
+    float* scale_K;
+    float* scale_V;
+    qint8_t (*res_K)[CFG::DK];      // [KV_RES][DK] 상주 버퍼
+    qint8_t (*res_V)[CFG::DV];
+    scale_type* res_scale_K;
+    scale_type* res_scale_V;
+    bool kv_resident;
+    int seq_len;
+    int head_dim;
+    bool causal;
+#if BLOCK_SPARSE
+    int* blk_ptr;                   // [SPARSE_TILES + 1] 온칩 CSR
+    int* blk_idx;                   // [SPARSE_BLOCKS]
+#endif
+
+    int first_block(int) const { return 0; }
+
+    int end_block(int i) const {
+#if BLOCK_SPARSE
+        // 이 Q 타일의 active KV 블록만 (목록 순서대로)
+        return blk_ptr[i / CFG::BR + 1] - blk_ptr[i / CFG::BR];
+#else
+        // causal 이면 대각 블록까지만
+        return (kv_range_end(i, seq_len, causal, CFG::BR) + CFG::BC - 1) / CFG::BC;
+#endif
+    }
+
+    int block_row(int i, int jb) const {
+#if BLOCK_SPARSE
+        return blk_idx[blk_ptr[i / CFG::BR] + jb] * CFG::BC;
+#else
+        (void)i;
+        return jb * CFG::BC;
+#endif
+    }
+
+    attn_tile_mask tile_mask(int i, int j) const {
+        return attn_causal_mask(seq_len, is_diag_tile(i, j, causal, CFG::BC));
+    }
+
+    void load(int, int, int j,
+              qint8_t kv_K[CFG::BC][CFG::DK], qint8_t kv_V[CFG::BC][CFG::DV],
+              scale_type kv_scale_K[CFG::BC], scale_type kv_scale_V[CFG::BC]) const {
+        #pragma HLS INLINE
+        load_kv_task_tmpl<CFG>(K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                               kv_resident, j, seq_len, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+// Accumulate - 통계 초기화 후 src 의 KV 블록 전부 (src.load | process_task_tmpl DATAFLOW)
+// 누산기 (local_O / m / l) 는 호출하는 compute stage 가 선언 (정규화 / partial 출력은 그쪽 몫)
+template <class CFG, class SRC>
+void accumulate_q_tile_tmpl(
+    const SRC& src,
+    qint8_t tile_Q[CFG::BR][CFG::DK],
+    typename CFG::scale_type tile_scale_Q[CFG::BR],
+    int i,
+    typename CFG::scale_type attn_scale,
+    typename CFG::calc_type local_O[CFG::BR][CFG::DV],
+    typename CFG::calc_type local_m[CFG::BR],
+    typename CFG::calc_type local_l[CFG::BR]
+) {
+    #pragma HLS INLINE
+    typedef typename CFG::scale_type scale_type;
+
+    INIT_STATS:
+    for (int r = 0; r < CFG::BR; r++) {
+        #pragma HLS PIPELINE II=1
+        local_m[r] = -10000.0;
+        local_l[r] = 0;
+        for (int c = 0; c < CFG::DV; c++) {
+            local_O[r][c] = 0;
+        }
+    }
+
+    int first_kv_block = src.first_block(i);
+    int end_kv_block = src.end_block(i);
+
+    OUTER_KV_LOOP:
+    for (int jb = first_kv_block; jb < end_kv_block; jb++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=SRC::MAX_BLOCKS
+        #pragma HLS DATAFLOW
+
+        int j = src.block_row(i, jb);
+        attn_tile_mask mask = src.tile_mask(i, j);
+
+        // KV 블록 ping-pong 버퍼 - src.load 가 쓰고 process_task_tmpl 이 그대로 읽음
+        qint8_t kv_K[CFG::BC][CFG::DK];
+        #pragma HLS ARRAY_PARTITION variable=kv_K cyclic factor=SRC::KV_PARTITION dim=2
+        qint8_t kv_V[CFG::BC][CFG::DV];
+        #pragma HLS ARRAY_PARTITION variable=kv_V cyclic factor=SRC::KV_PARTITION dim=2
+        scale_type kv_scale_K[CFG::BC];
+        scale_type kv_scale_V[CFG::BC];
+
+        src.load(i, jb, j, kv_K, kv_V, kv_scale_K, kv_scale_V);
+
+        process_task_tmpl<CFG>(kv_K, kv_V, kv_scale_K, kv_scale_V, tile_Q, tile_scale_Q, local_O, local_m, local_l,
+                               i, j, mask, attn_scale);
+    }
+}
+
+// Compute - Q 타일 하나에 대해 accumulate 후 정규화 (1 / l) 해서 출력 타일로
+template <class CFG, class SRC>
+void compute_q_tile_tmpl(
+    const SRC& src,
+    qint8_t tile_Q[CFG::BR][CFG::DK],
+    typename CFG::scale_type tile_scale_Q[CFG::BR],
+    int i,
+    typename CFG::scale_type attn_scale,
+    typename CFG::fixed_type tile_O[CFG::BR][CFG::DV]
+) {
+    #pragma HLS INLINE off
+    typedef typename CFG::calc_type calc_type;
+    typedef typename CFG::fixed_type fixed_type;
+
+    calc_type local_O[CFG::BR][CFG::DV];
+    #pragma HLS ARRAY_PARTITION variable=local_O cyclic factor=CFG::ROW_ENGINES dim=1
+    calc_type local_m[CFG::BR];
+    #pragma HLS ARRAY_PARTITION variable=local_m complete
+    calc_type local_l[CFG::BR];
+    #pragma HLS ARRAY_PARTITION variable=local_l complete
+
+    accumulate_q_tile_tmpl<CFG>(src, tile_Q, tile_scale_Q, i, attn_scale, local_O, local_m, local_l);
+
+    NORMALIZE_O:
+    for (int r = 0; r < CFG::BR; r++) {
+        #pragma HLS PIPELINE II=1
+        calc_type inv_sum = attn_recip<calc_type>(local_l[r]);
+        for (int v = 0; v < CFG::DV; v++) {
+            tile_O[r][v] = (fixed_type)(local_O[r][v] * inv_sum);
+        }
+    }
+}
+
+// Write - 정규화된 출력 타일을 DDR 로 (seq_len / head_dim 밖은 쓰지 않음)
+// INT8_OUTPUT: fixed_type 행 그대로 quant_row_absmax (다른 variant 와 같은 양자화 규칙)
+template <class CFG>
+void write_output_task_tmpl(
+    typename CFG::fixed_type tile_O[CFG::BR][CFG::DV],
+    int i,
+    int seq_len,
+    int head_dim,
+#if INT8_OUTPUT
+    float Output_scale[CFG::NMAX],
+#endif
+    typename CFG::out_type Output[CFG::NMAX][CFG::DV]
+) {
+    #pragma HLS INLINE off
+
+    WRITE_OUTPUT:
+    for (int r = 0; r < CFG::BR; r++) {
+        #pragma HLS PIPELINE II=1
+#if INT8_OUTPUT
+        qint8_t q_row[CFG::DV];
+        #pragma HLS ARRAY_PARTITION variable=q_row complete
+        auto o_absmax = quant_row_absmax<CFG::DV>(tile_O[r], head_dim, q_row);
+        if (i + r < seq_len) {
+            DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+            Output_scale[i + r] = quant_out_scale(o_absmax);
+        }
+        for (int v = 0; v < CFG::DV; v++) {
+            if (i + r < seq_len && v < head_dim) {
+                Output[i + r][v] = q_row[v];
+            }
+        }
+#else
+        if (i + r < seq_len) DDR_WRITE(head_dim * CFG::OUT_BYTES);
+        for (int v = 0; v < CFG::DV; v++) {
+            if (i + r < seq_len && v < head_dim) {
+                Output[i + r][v] = tile_O[r][v];
+            }
+        }
+#endif
+    }
+}
+
+
+// --------------------------------------------------------
+// kernel 본체 - HLS top 은 top_flash_attention_template.cpp 의 wrapper
+// --------------------------------------------------------
+template <class CFG>
+void compute_attention_tmpl(
+    qint8_t Q[CFG::NMAX][CFG::DK],
+    qint8_t K[CFG::NMAX][CFG::DK],
+    qint8_t V[CFG::NMAX][CFG::DV],
+    typename CFG::out_type Output[CFG::NMAX][CFG::DV],
+    float scale_Q[CFG::NMAX],
+    float scale_K[CFG::NMAX],
+    float scale_V[CFG::NMAX],
+#if INT8_OUTPUT
+    float Output_scale[CFG::NMAX],
+#endif
+#if BLOCK_SPARSE
+    int kv_block_ptr[CFG::SPARSE_TILES + 1],
+    int kv_block_idx[CFG::SPARSE_BLOCKS],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal
+) {
+    #pragma HLS INLINE
+    typedef typename CFG::scale_type scale_type;
+    typedef typename CFG::fixed_type fixed_type;
+
+    qint8_t res_K[CFG::KV_RES][CFG::DK];
+    #pragma HLS BIND_STORAGE variable=res_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_K cyclic factor=4 dim=2
+    qint8_t res_V[CFG::KV_RES][CFG::DV];
+    #pragma HLS BIND_STORAGE variable=res_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_V cyclic factor=4 dim=2
+    scale_type res_scale_K[CFG::KV_RES];
+    scale_type res_scale_V[CFG::KV_RES];
+
+    // head_dim == DK 이면 컴파일 타임 상수, 줄인 head_dim 만 런타임 1/sqrt
+    const scale_type ATTN_SCALE_DK = (scale_type)CFG::attn_scale();
+    scale_type attn_scale = (head_dim == CFG::DK)
+        ? ATTN_SCALE_DK
+        : (scale_type)(1.0f / hls::sqrt((float)head_dim));
+
+    // K/V 상주 모드: 전체 K/V 를 한 번만 DDR 에서 읽고 모든 Q 타일에서 재사용
+    // (스트리밍 모드는 Q 타일마다 K/V 전체를 다시 읽음 -> NMAX/BR 배 트래픽)
+    bool kv_resident = (seq_len <= CFG::KV_RES);
+
+#if BLOCK_SPARSE
+    // active 블록 CSR - 시작할 때 온칩으로 (Q 타일마다 DDR 왕복 없음)
+    int blk_ptr[CFG::SPARSE_TILES + 1];
+    int blk_idx[CFG::SPARSE_BLOCKS];
+    load_block_list<CFG::BR, CFG::SPARSE_TILES, CFG::SPARSE_BLOCKS>(kv_block_ptr, kv_block_idx, seq_len,
+                                                                   blk_ptr, blk_idx);
+#endif
+
+    if (kv_resident) {
+        load_kv_resident_tmpl<CFG>(K, V, scale_K, scale_V, seq_len, head_dim,
+                                   res_K, res_V, res_scale_K, res_scale_V);
+    }
+
+#if BLOCK_SPARSE
+    attn_kv_source<CFG> src = { K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                                kv_resident, seq_len, head_dim, causal, blk_ptr, blk_idx };
+#else
+    attn_kv_source<CFG> src = { K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                                kv_resident, seq_len, head_dim, causal };
+#endif
+
+    int num_q_tiles = (seq_len + CFG::BR - 1) / CFG::BR;
+
+    OUTER_Q_LOOP:
+    for (int ib = 0; ib < num_q_tiles; ib++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=CFG::NMAX/CFG::BR
+        #pragma HLS DATAFLOW
+
+        int i = ib * CFG::BR;
+
+        qint8_t tile_Q[CFG::BR][CFG::DK];
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=CFG::ROW_ENGINES dim=1
+        scale_type tile_scale_Q[CFG::BR];
+        #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=CFG::ROW_ENGINES
+        fixed_type tile_O[CFG::BR][CFG::DV];
+        #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+        load_q_task_tmpl<CFG>(Q, scale_Q, i, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+        compute_q_tile_tmpl<CFG>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+#if INT8_OUTPUT
+        write_output_task_tmpl<CFG>(tile_O, i, seq_len, head_dim, Output_scale, Output);
+#else
+        write_output_task_tmpl<CFG>(tile_O, i, seq_len, head_dim, Output);
+#endif
+    }
+}
+
+
+// explicit instantiation 은 top_flash_attention_template.cpp 에만 (host 는 링크만)
+#if INT8_OUTPUT
+#define ATTN_TMPL_OUTPUT_SCALE(CFG) float[CFG::NMAX],
+#else
+#define ATTN_TMPL_OUTPUT_SCALE(CFG)
+#endif
+#if BLOCK_SPARSE
+#define ATTN_TMPL_BLOCK_LIST(CFG) int[CFG::SPARSE_TILES + 1], int[CFG::SPARSE_BLOCKS],
+#else
+#define ATTN_TMPL_BLOCK_LIST(CFG)
+#endif
+#define ATTN_TMPL_INSTANCE(CFG)                                                                \
+    void compute_attention_tmpl<CFG>(                                                          \
+        qint8_t[CFG::NMAX][CFG::DK], qint8_t[CFG::NMAX][CFG::DK], qint8_t[CFG::NMAX][CFG::DV], \
+        CFG::out_type[CFG::NMAX][CFG::DV], float[CFG::NMAX], float[CFG::NMAX], float[CFG::NMAX], \
+        ATTN_TMPL_OUTPUT_SCALE(CFG) ATTN_TMPL_BLOCK_LIST(CFG) int, int, bool)
+
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d64_b16);
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d64_b32);
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d64_b64);
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d128_b16);
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d128_b32);
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d128_b64);
+extern template ATTN_TMPL_INSTANCE(attn_cfg_d64_b32_wide);
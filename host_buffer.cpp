@@ -0,0 +1,102 @@
+#include "host_buffer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// --------------------------------------------------------
+// Pool - (크기, 포인터) free list
+// 사용 중인 블록 크기도 기억해서 free 때 free list 로 옮김
+// --------------------------------------------------------
+struct pool_block {
+    void* ptr;
+    size_t bytes;
+};
+
+static std::mutex pool_mutex;
+static std::vector<pool_block> pool_free;
+static std::vector<pool_block> pool_used;
+
+static size_t round_up(size_t bytes) {
+    return (bytes + HOST_BUFFER_ALIGN - 1) / HOST_BUFFER_ALIGN * HOST_BUFFER_ALIGN;
+}
+
+void* host_buffer_alloc(size_t bytes) {
+    bytes = round_up(bytes ? bytes : 1);
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    for (size_t b = 0; b < pool_free.size(); b++) {
+        if (pool_free[b].bytes == bytes) {
+            pool_block blk = pool_free[b];
+            pool_free.erase(pool_free.begin() + b);
+            pool_used.push_back(blk);
+            return blk.ptr;
+        }
+    }
+
+    void* ptr = aligned_alloc(HOST_BUFFER_ALIGN, bytes);
+    if (ptr == NULL) {
+        fprintf(stderr, "host_buffer_alloc: out of memory (%zu bytes)\n", bytes);
+        exit(1);
+    }
+    pool_used.push_back({ ptr, bytes });
+    return ptr;
+}
+
+void host_buffer_free(void* ptr) {
+    if (ptr == NULL) return;
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    for (size_t b = 0; b < pool_used.size(); b++) {
+        if (pool_used[b].ptr == ptr) {
+            pool_free.push_back(pool_used[b]);
+            pool_used.erase(pool_used.begin() + b);
+            return;
+        }
+    }
+    fprintf(stderr, "host_buffer_free: pointer not from host_buffer_alloc\n");
+    exit(1);
+}
+
+void host_buffer_pool_trim() {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    for (size_t b = 0; b < pool_free.size(); b++) {
+        free(pool_free[b].ptr);
+    }
+    pool_free.clear();
+}
+
+// --------------------------------------------------------
+// attention_buffers - Q/K/V int8 (reference 와 커널 공유), scale, 출력
+// --------------------------------------------------------
+void attention_buffers_acquire(attention_buffers* b) {
+    b->Q          = (int8_t (*)[dk])host_buffer_alloc(sizeof(int8_t) * N * dk);
+    b->K          = (int8_t (*)[dk])host_buffer_alloc(sizeof(int8_t) * N * dk);
+    b->V          = (int8_t (*)[dv])host_buffer_alloc(sizeof(int8_t) * N * dv);
+    b->scale_Q    = (float*)host_buffer_alloc(sizeof(float) * N);
+    b->scale_K    = (float*)host_buffer_alloc(sizeof(float) * N);
+    b->scale_V    = (float*)host_buffer_alloc(sizeof(float) * N);
+    b->Output_ref = (float (*)[dv])host_buffer_alloc(sizeof(float) * N * dv);
+    b->Output_scale = (float*)host_buffer_alloc(sizeof(float) * N);
+
+    // out_t (fixed_t / ap_int) 는 class 타입 - pool 메모리 위에 원소별 생성
+    out_t* out = (out_t*)host_buffer_alloc(sizeof(out_t) * N * dv);
+    for (int e = 0; e < N * dv; e++) {
+        new (&out[e]) out_t();
+    }
+    b->Output = (out_t (*)[dv])out;
+}
+
+void attention_buffers_release(attention_buffers* b) {
+    host_buffer_free(b->Q);
+    host_buffer_free(b->K);
+    host_buffer_free(b->V);
+    host_buffer_free(b->scale_Q);
+    host_buffer_free(b->scale_K);
+    host_buffer_free(b->scale_V);
+    host_buffer_free(b->Output_ref);
+    host_buffer_free(b->Output_scale);
+    host_buffer_free(b->Output);    // out_t 는 trivially destructible
+    *b = attention_buffers();
+}
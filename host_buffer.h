@@ -0,0 +1,44 @@
+#pragma once
+#include "dcl_optimized.h"
+#include <cstddef>
+
+// --------------------------------------------------------
+// Host 버퍼 pool (host_buffer.cpp)
+// --------------------------------------------------------
+// 64 byte 정렬 heap 할당, 해제한 블록은 같은 크기 요청에 재사용
+// (testbench 케이스 / 반복 launch 마다 새로 할당하지 않음)
+#define HOST_BUFFER_ALIGN 64
+
+void* host_buffer_alloc(size_t bytes);
+void  host_buffer_free(void* ptr);          // pool 로 반환
+void  host_buffer_pool_trim();              // pool 에 남은 블록 실제 해제
+
+// --------------------------------------------------------
+// int8_t <-> qint8_t layout 호환 view
+// --------------------------------------------------------
+// ap_int<8> 는 1 byte storage 라 int8_t 버퍼를 그대로 커널 포트에 넘길 수 있음
+// reference (int8_t) 와 커널 (qint8_t) 이 같은 버퍼를 공유 - 형변환 복사 없음
+static_assert(sizeof(qint8_t) == sizeof(int8_t), "qint8_t must be layout-compatible with int8_t");
+
+template <int COLS>
+inline qint8_t (*qint8_view(int8_t (*buf)[COLS]))[COLS] {
+    return reinterpret_cast<qint8_t (*)[COLS]>(buf);
+}
+
+// --------------------------------------------------------
+// compute_attention_HLS 1회 분 host 버퍼 (N x dk 최대 크기)
+// --------------------------------------------------------
+struct attention_buffers {
+    int8_t  (*Q)[dk];
+    int8_t  (*K)[dk];
+    int8_t  (*V)[dv];
+    float*  scale_Q;
+    float*  scale_K;
+    float*  scale_V;
+    out_t   (*Output)[dv];      // 커널 출력 (INT8_OUTPUT 이면 int8)
+    float*  Output_scale;       // INT8_OUTPUT 행별 출력 scale
+    float   (*Output_ref)[dv];  // fp32 reference
+};
+
+void attention_buffers_acquire(attention_buffers* b);
+void attention_buffers_release(attention_buffers* b);
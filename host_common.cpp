@@ -0,0 +1,169 @@
+#include "host_common.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// csim DDR 트래픽 카운터 (커널에서 증가)
+thread_local ddr_stats_t ddr_stats;
+
+// --------------------------------------------------------
+// [표준 C 타입] INT8 텐서 로드 함수 (검증용/파일입력용)
+// --------------------------------------------------------
+void load_tensor_int8(const char* filename, int8_t* tensor, int size) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        exit(1);
+    }
+
+    size_t elements_read = fread(tensor, sizeof(int8_t), size, file);
+    if (elements_read != (size_t)size) {
+        fprintf(stderr, "Error reading file: %s (read %zu, expected %d)\n", 
+                filename, elements_read, size);
+        fclose(file);
+        exit(1);
+    }
+
+    fclose(file);
+}
+
+// --------------------------------------------------------
+// Scale factor 로드 함수
+// --------------------------------------------------------
+void load_scale(const char* filename, float* scale, int size) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        exit(1);
+    }
+
+    size_t elements_read = fread(scale, sizeof(float), size, file);
+    if (elements_read != (size_t)size) {
+        fprintf(stderr, "Error reading file: %s (read %zu, expected %d)\n", 
+                filename, elements_read, size);
+        fclose(file);
+        exit(1);
+    }
+
+    fclose(file);
+}
+
+// --------------------------------------------------------
+// fixed_t raw 덤프 로드 (int16 bit 패턴 그대로)
+// --------------------------------------------------------
+void load_tensor_fixed(const char* filename, fixed_t* tensor, int size) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        exit(1);
+    }
+
+    for (int e = 0; e < size; e++) {
+        int16_t raw;
+        if (fread(&raw, sizeof(int16_t), 1, file) != 1) {
+            fprintf(stderr, "Error reading file: %s (read %d, expected %d)\n",
+                    filename, e, size);
+            fclose(file);
+            exit(1);
+        }
+        tensor[e].range(15, 0) = raw;
+    }
+
+    fclose(file);
+}
+
+// --------------------------------------------------------
+// FP32 Reference Attention (검증용 - 표준 C 타입 사용)
+// 앞쪽 seq_len 행, head_dim 열만 사용
+// causal 이면 j <= i 인 key 만 사용
+// --------------------------------------------------------
+void reference_attention_fp32(
+    const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+    const float Q_scale[N], const float K_scale[N], const float V_scale[N],
+    float Output_ref[N][dv],
+    int seq_len, int head_dim, bool causal
+) {
+    float scale = 1.0f / sqrtf((float)head_dim);
+    
+    for (int i = 0; i < seq_len; i++) {
+        int kv_len = causal ? i + 1 : seq_len;
+
+        // 1. Score 계산
+        float scores[N];
+        float max_val = -1e9;
+
+        for (int j = 0; j < kv_len; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < head_dim; k++) {
+                float q_val = (float)Q[i][k] * Q_scale[i];
+                float k_val = (float)K[j][k] * K_scale[j];
+                sum += q_val * k_val;
+            }
+            scores[j] = sum * scale;
+            if (scores[j] > max_val) max_val = scores[j];
+        }
+        
+        // 2. Softmax
+        float sum_exp = 0.0f;
+        float P[N];
+        for (int j = 0; j < kv_len; j++) {
+            P[j] = expf(scores[j] - max_val);
+            sum_exp += P[j];
+        }
+        
+        for (int j = 0; j < kv_len; j++) {
+            P[j] /= sum_exp;
+        }
+        
+        // 3. Output Update
+        for (int d = 0; d < head_dim; d++) {
+            float sum_v = 0.0f;
+            for (int j = 0; j < kv_len; j++) {
+                float v_val = (float)V[j][d] * V_scale[j];
+                sum_v += P[j] * v_val;
+            }
+            Output_ref[i][d] = sum_v;
+        }
+    }
+}
+
+// --------------------------------------------------------
+// 커널 출력 -> float
+// --------------------------------------------------------
+float output_value(const out_t out[][dv], const float out_scale[], int i, int d) {
+#if INT8_OUTPUT
+    return out[i][d].to_int() * out_scale[i];
+#else
+    (void)out_scale;
+    return out[i][d].to_float();
+#endif
+}
+
+// --------------------------------------------------------
+// Softmax exp / reciprocal 유닛 정확도
+// 커널이 실제로 보는 입력 범위: exp 는 [-20, 0], recip 은 [1, N]
+// --------------------------------------------------------
+void report_softmax_units() {
+    double exp_err = 0.0;
+    for (double x = 0.0; x > -20.0; x -= 0.000731) {
+        ap_fixed<32,16> in = x;
+        double err = fabs(attn_exp(in).to_double() - exp(in.to_double()));
+        if (err > exp_err) exp_err = err;
+    }
+
+    double recip_err = 0.0;
+    for (double x = 1.0; x < N; x += 0.0137) {
+        ap_fixed<32,16> in = x;
+        double err = fabs(attn_recip(in).to_double() - 1.0 / in.to_double());
+        if (err > recip_err) recip_err = err;
+    }
+
+#if USE_FIXED_EXP
+    printf("Softmax units: fixed LUT (EXP_LUT_BITS=%d, RECIP_LUT_BITS=%d)\n", EXP_LUT_BITS, RECIP_LUT_BITS);
+#else
+    printf("Softmax units: float hls::exp / fixed divide\n");
+#endif
+    // LSB = ap_fixed<32,16> 최하위 bit (2^-16)
+    printf("  exp   max error: %.3g (%.2f LSB)\n", exp_err, exp_err * 65536.0);
+    printf("  recip max error: %.3g (%.2f LSB)\n", recip_err, recip_err * 65536.0);
+}
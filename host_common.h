@@ -0,0 +1,27 @@
+#pragma once
+#include "dcl_optimized.h"
+
+// --------------------------------------------------------
+// Testbench 공통 함수 (host_common.cpp)
+// --------------------------------------------------------
+
+// INT8 텐서 / scale 파일 로드 (실패 시 exit)
+void load_tensor_int8(const char* filename, int8_t* tensor, int size);
+void load_scale(const char* filename, float* scale, int size);
+// fixed_t (ap_fixed<16,5>) raw int16 덤프 로드 (Q_tensor.bin, Output_tensor.bin 등)
+void load_tensor_fixed(const char* filename, fixed_t* tensor, int size);
+
+// FP32 Reference Attention - 앞쪽 seq_len 행, head_dim 열만 사용
+// causal 이면 j <= i 인 key 만 사용
+void reference_attention_fp32(
+    const int8_t Q[N][dk], const int8_t K[N][dk], const int8_t V[N][dv],
+    const float Q_scale[N], const float K_scale[N], const float V_scale[N],
+    float Output_ref[N][dv],
+    int seq_len, int head_dim, bool causal
+);
+
+// 커널 출력 행 i, 열 d -> float (INT8_OUTPUT 이면 int8 * out_scale[i] 로 dequant, 아니면 out_scale 무시)
+float output_value(const out_t out[][dv], const float out_scale[], int i, int d);
+
+// attn_exp / attn_recip 단독 정확도 (std::exp, 1/x 대비 최대 오차) 출력
+void report_softmax_units();
@@ -0,0 +1,192 @@
+// csim 소스: host_decode.cpp host_common.cpp top_flash_attention_decode.cpp top_flash_attention_DATAFLOW.cpp
+// incremental decode variant 를 step 별로 돌려서 (토큰 하나씩 append) 전체 causal DATAFLOW variant 와 비교
+//   - step pos 의 출력은 compute_attention_HLS (causal, seq_len = gen_len) 의 행 pos 와 bit 단위로 같아야 함
+//   - 끝나고 KV cache 가 입력 K/V 와 같아야 함 (append 확인)
+//   - 토큰당 시간 / DDR 트래픽을 compute_attention_HLS (seq_len = N) 1 회 호출과 비교
+#include "host_common.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct TestCase {
+    int gen_len;        // decode step 수 (= 마지막 cache 길이)
+    int head_dim;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk },
+    { 333, 48 },
+    { 17,  dk },
+};
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+
+static out_t Output_full[N][dv];
+static float Output_full_scale[N];
+
+// decode 상태 - 호출 사이에 유지되는 KV cache
+static qint8_t K_cache[N][dk];
+static qint8_t V_cache[N][dv];
+static float scale_K_cache[N];
+static float scale_V_cache[N];
+static out_t Output_step[N][dv];
+static float Output_step_scale[N];
+
+// --------------------------------------------------------
+// 테스트 1회 - gen_len step decode, RMSE 반환 (불일치는 실패)
+// --------------------------------------------------------
+static double run_test(int gen_len, int head_dim) {
+    printf("==============================================\n");
+    printf("gen_len=%d, head_dim=%d\n", gen_len, head_dim);
+    printf("==============================================\n");
+
+    srand(42);
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            Q_hls[i][k] = Q_ref[i][k];
+            K_hls[i][k] = K_ref[i][k];
+            K_cache[i][k] = (qint8_t)(rand() % 256 - 128);     // 아직 안 쓴 cache 는 쓰레기 값
+        }
+        for (int v = 0; v < dv; v++) {
+            V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+            V_hls[i][v] = V_ref[i][v];
+            V_cache[i][v] = (qint8_t)(rand() % 256 - 128);
+            Output_full[i][v] = 0;
+            Output_step[i][v] = 0;
+        }
+        Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        scale_K_cache[i] = 1.0f;
+        scale_V_cache[i] = 1.0f;
+        Output_full_scale[i] = 0.0f;
+        Output_step_scale[i] = 0.0f;
+    }
+
+    reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref,
+                             gen_len, head_dim, true);
+
+    // 기준: 전체 causal (prefill 한 번)
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_full, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_full_scale,
+#endif
+                          gen_len, head_dim, true);
+
+    // decode: 토큰 하나씩
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    for (int pos = 0; pos < gen_len; pos++) {
+        compute_attention_decode_HLS(Q_hls[pos], K_hls[pos], V_hls[pos], Q_scale[pos], K_scale[pos], V_scale[pos],
+                                     K_cache, V_cache, scale_K_cache, scale_V_cache, Output_step[pos],
+#if INT8_OUTPUT
+                                     &Output_step_scale[pos],
+#endif
+                                     pos, head_dim);
+    }
+    auto t_end = chrono::steady_clock::now();
+    double decode_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    unsigned long long decode_read = ddr_stats.read_bytes;
+    unsigned long long decode_write = ddr_stats.write_bytes;
+
+    int mismatches = 0, cache_mismatches = 0;
+    double mse = 0.0;
+    for (int i = 0; i < gen_len; i++) {
+        for (int d = 0; d < head_dim; d++) {
+            if (Output_step[i][d] != Output_full[i][d]) mismatches++;
+            double error = output_value(Output_step, Output_step_scale, i, d) - Output_ref[i][d];
+            mse += error * error;
+            if (K_cache[i][d] != K_hls[i][d] || V_cache[i][d] != V_hls[i][d]) cache_mismatches++;
+        }
+#if INT8_OUTPUT
+        if (Output_step_scale[i] != Output_full_scale[i]) mismatches++;
+#endif
+        if (scale_K_cache[i] != K_scale[i] || scale_V_cache[i] != V_scale[i]) cache_mismatches++;
+    }
+    double rmse = sqrt(mse / (gen_len * head_dim));
+
+    printf("decode %d steps: RMSE %.8f, vs full causal: %d values differ, cache mismatches %d\n",
+           gen_len, rmse, mismatches, cache_mismatches);
+    printf("  per token: %8.3f ms, DDR read %8.0f / write %5.0f bytes (avg over steps)\n",
+           decode_ms / gen_len, (double)decode_read / gen_len, (double)decode_write / gen_len);
+    printf("\n");
+
+    return (mismatches == 0 && cache_mismatches == 0) ? rmse : 1e9;
+}
+
+// --------------------------------------------------------
+// 기존 방식 (step 마다 compute_attention_HLS 를 N=512 로 호출) 의 토큰당 비용
+// --------------------------------------------------------
+static void report_full_call(int head_dim) {
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_full, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_full_scale,
+#endif
+                          N, head_dim, true);
+    auto t_end = chrono::steady_clock::now();
+    double full_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    printf("compute_attention_HLS (N=%d, causal) per token: %8.3f ms, DDR read %llu / write %llu bytes\n",
+           N, full_ms, ddr_stats.read_bytes, ddr_stats.write_bytes);
+
+    // decode 마지막 step (pos = N - 1) 과 같은 조건
+    ddr_stats = ddr_stats_t();
+    t_start = chrono::steady_clock::now();
+    compute_attention_decode_HLS(Q_hls[N - 1], K_hls[N - 1], V_hls[N - 1], Q_scale[N - 1], K_scale[N - 1], V_scale[N - 1],
+                                 K_cache, V_cache, scale_K_cache, scale_V_cache, Output_step[N - 1],
+#if INT8_OUTPUT
+                                 &Output_step_scale[N - 1],
+#endif
+                                 N - 1, head_dim);
+    t_end = chrono::steady_clock::now();
+    double step_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    printf("compute_attention_decode_HLS (pos=%d) per token : %8.3f ms, DDR read %llu / write %llu bytes (%.1fx faster)\n",
+           N - 1, step_ms, ddr_stats.read_bytes, ddr_stats.write_bytes, full_ms / step_ms);
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention incremental decode testbench\n");
+    printf("N=%d, dk=%d, dv=%d, Bc=%d, INT8_OUTPUT=%d\n", N, dk, dv, Bc, INT8_OUTPUT);
+    printf("==============================================\n\n");
+
+    double worst_rmse = 0.0;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_test(test_cases[t].gen_len, test_cases[t].head_dim);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+
+    // 첫 테스트 케이스 (N, dk) 를 다시 채워서 cache 가 N 행 다 찬 상태로 비교
+    run_test(N, dk);
+    report_full_call(dk);
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+// csim 소스: host_multihead.cpp host_common.cpp top_flash_attention_multihead.cpp
+#include "host_common.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+using namespace std;
+
+// Testbench batch / head 수
+#define TB_BATCH  2
+#define TB_HEADS  8
+#define TB_BH     (TB_BATCH * TB_HEADS)
+
+// --------------------------------------------------------
+// 테스트 케이스 (seq_len, head_dim, causal, kv_heads)
+// kv_heads == TB_HEADS : MHA, 1 < kv_heads < TB_HEADS : GQA, kv_heads == 1 : MQA
+// --------------------------------------------------------
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+    int kv_heads;
+};
+
+static const TestCase test_cases[] = {
+    { 100, dk, true,  TB_HEADS },
+    { N,   dk, false, 2        },
+    { 333, 48, false, 1        },
+    { 100, dk, true,  1        },
+};
+
+// [batch * heads][N][dk] 텐서 (스택 대신 static)
+// K/V 는 [batch * kv_heads] 만 사용
+static int8_t Q_ref[TB_BH][N][dk];
+static int8_t K_ref[TB_BH][N][dk];
+static int8_t V_ref[TB_BH][N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[TB_BH][N][dk];
+static qint8_t K_hls[TB_BH][N][dk];
+static qint8_t V_hls[TB_BH][N][dv];
+static out_t Output_HLS[TB_BH][N][dv];
+static float Output_scale[TB_BH][N];
+
+static float Q_scale[TB_BH][N];
+static float K_scale[TB_BH][N];
+static float V_scale[TB_BH][N];
+
+// --------------------------------------------------------
+// 테스트 1회 실행 (layer 전체 1회 호출) - head 중 최대 RMSE 반환
+// --------------------------------------------------------
+double run_test(int seq_len, int head_dim, bool causal, int kv_heads) {
+    const int group = TB_HEADS / kv_heads;
+
+    printf("==============================================\n");
+    printf("batch=%d, heads=%d, kv_heads=%d (group=%d), seq_len=%d, head_dim=%d, causal=%d\n",
+           TB_BATCH, TB_HEADS, kv_heads, group, seq_len, head_dim, (int)causal);
+    printf("==============================================\n");
+
+    printf("Generating random test data...\n");
+    srand(42);
+    for (int bh = 0; bh < TB_BH; bh++) {
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[bh][i][k] = (int8_t)(rand() % 256 - 128);
+                K_ref[bh][i][k] = (int8_t)(rand() % 256 - 128);
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[bh][i][v] = (int8_t)(rand() % 256 - 128);
+            }
+
+            Q_scale[bh][i] = 0.02f + (rand() % 100) * 0.0005f;
+            K_scale[bh][i] = 0.02f + (rand() % 100) * 0.0005f;
+            V_scale[bh][i] = 0.02f + (rand() % 100) * 0.0005f;
+            Output_scale[bh][i] = 0.0f;
+        }
+    }
+
+    for (int bh = 0; bh < TB_BH; bh++) {
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_hls[bh][i][k] = Q_ref[bh][i][k];
+                K_hls[bh][i][k] = K_ref[bh][i][k];
+            }
+            for (int v = 0; v < dv; v++) {
+                V_hls[bh][i][v] = V_ref[bh][i][v];
+                Output_HLS[bh][i][v] = 0;
+            }
+        }
+    }
+
+    // --------------------------------------------------------
+    // HLS 커널 호출 (layer 전체 1회)
+    // --------------------------------------------------------
+    printf("Running batched HLS kernel...\n");
+    ddr_stats.read_bytes = 0;
+    ddr_stats.write_bytes = 0;
+    auto t_start = chrono::steady_clock::now();
+    compute_attention_batched_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                                  Output_scale,
+#endif
+                                  TB_BATCH, TB_HEADS, kv_heads, seq_len, head_dim, causal);
+    auto t_end = chrono::steady_clock::now();
+    double kernel_ms = chrono::duration<double, milli>(t_end - t_start).count();
+
+    // --------------------------------------------------------
+    // head 별 Reference 비교
+    // --------------------------------------------------------
+    double worst_rmse = 0.0;
+    for (int bh = 0; bh < TB_BH; bh++) {
+        // query head (b, h) -> KV head (b, h / group)
+        int bkv = (bh / TB_HEADS) * kv_heads + (bh % TB_HEADS) / group;
+        reference_attention_fp32(Q_ref[bh], K_ref[bkv], V_ref[bkv],
+                                 Q_scale[bh], K_scale[bkv], V_scale[bkv], Output_ref,
+                                 seq_len, head_dim, causal);
+
+        double mse = 0.0;
+        double max_error = 0.0;
+        for (int i = 0; i < seq_len; i++) {
+            for (int d = 0; d < head_dim; d++) {
+#if INT8_OUTPUT
+                float out = Output_HLS[bh][i][d].to_int() * Output_scale[bh][i];
+#else
+                float out = Output_HLS[bh][i][d].to_float();
+#endif
+                float error = out - Output_ref[i][d];
+                mse += error * error;
+                if (fabs(error) > max_error) max_error = fabs(error);
+            }
+        }
+        mse /= (seq_len * head_dim);
+        double rmse = sqrt(mse);
+
+        printf("  head [b=%d][h=%d]  RMSE: %.8f  Max Error: %.8f\n",
+               bh / TB_HEADS, bh % TB_HEADS, rmse, max_error);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+
+    printf("Kernel time (csim): %.3f ms\n", kernel_ms);
+    // K/V 는 KV head 당 한 번, Q 는 query head 당 한 번
+    unsigned long long kv_bytes =
+        (unsigned long long)TB_BATCH * kv_heads * seq_len * (2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    unsigned long long q_bytes =
+        (unsigned long long)TB_BH * seq_len * (head_dim * QINT8_BYTES + SCALE_BYTES);
+    printf("DDR read:   %llu bytes (Q %llu + K/V %llu, K/V 1/%d of per-query-head loading)\n",
+           ddr_stats.read_bytes, q_bytes, kv_bytes, group);
+    printf("DDR write:  %llu bytes\n\n", ddr_stats.write_bytes);
+
+    return worst_rmse;
+}
+
+// --------------------------------------------------------
+// 잘못된 kv_heads (0, heads 의 약수 아님) / batch (0 이하, MAX_BATCH 초과) - 커널이 아무것도 쓰지 않아야 함
+// --------------------------------------------------------
+int check_invalid_kv_heads() {
+    static const int bad_batch[]    = { TB_BATCH, TB_BATCH, TB_BATCH, 0, -1, MAX_BATCH + 1 };
+    static const int bad_kv_heads[] = { 0,        3,        -2,       2, 2,  2             };
+    int writes = 0;
+    for (int t = 0; t < (int)(sizeof(bad_kv_heads) / sizeof(bad_kv_heads[0])); t++) {
+        for (int bh = 0; bh < TB_BH; bh++)
+            for (int i = 0; i < N; i++)
+                for (int d = 0; d < dv; d++) Output_HLS[bh][i][d] = 7;
+        compute_attention_batched_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                                      Output_scale,
+#endif
+                                      bad_batch[t], TB_HEADS, bad_kv_heads[t], 100, dk, false);
+        for (int bh = 0; bh < TB_BH; bh++)
+            for (int i = 0; i < N; i++)
+                for (int d = 0; d < dv; d++)
+                    if (Output_HLS[bh][i][d] != 7) writes++;
+        printf("batch=%d kv_heads=%d (heads=%d): output writes %d\n", bad_batch[t], bad_kv_heads[t], TB_HEADS, writes);
+    }
+    return writes;
+}
+
+// --------------------------------------------------------
+// Main
+// --------------------------------------------------------
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention INT8 Batched Testbench\n");
+    printf("N=%d, dk=%d, dv=%d, INT8_OUTPUT=%d\n", N, dk, dv, INT8_OUTPUT);
+    report_softmax_units();
+    printf("==============================================\n\n");
+
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    double worst_rmse = 0.0;
+
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_test(test_cases[t].seq_len, test_cases[t].head_dim,
+                               test_cases[t].causal, test_cases[t].kv_heads);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+    if (check_invalid_kv_heads() != 0) worst_rmse = 1e9;
+    printf("\n");
+
+    // Pass/Fail 판정 (가장 나쁜 head 기준)
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
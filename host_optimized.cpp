@@ -1,157 +1,94 @@
-#include "dcl_optimized.h"
+// csim 소스: host_optimized.cpp host_common.cpp host_buffer.cpp attention_engine.cpp cpu_attention.cpp tensor_file.cpp
+//           top_flash_attention_<variant>.cpp
+// 실행: ./tb [--backend=hls|cpu] [--threads=N] [--input=FILE.tfc]
+//   cpu   = compute_attention_cpu fallback
+//   input = pack_tensors 로 만든 tensor container (없으면 random 데이터)
+#include "host_common.h"
+#include "attention_engine.h"
+#include "cpu_attention.h"
+#include "tensor_file.h"
+#include "host_buffer.h"
 #include <cmath>
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <chrono>
 
 using namespace std;
 
 // --------------------------------------------------------
-// [표준 C 타입] INT8 텐서 로드 함수 (검증용/파일입력용)
+// 테스트 케이스 (seq_len, head_dim, causal)
+// Br/Bc(32)의 배수가 아닌 길이로 마지막 타일 마스킹 검증
 // --------------------------------------------------------
-void load_tensor_int8(const char* filename, int8_t* tensor, int size) {
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) {
-        fprintf(stderr, "Error opening file: %s\n", filename);
-        exit(1);
-    }
-
-    size_t elements_read = fread(tensor, sizeof(int8_t), size, file);
-    if (elements_read != (size_t)size) {
-        fprintf(stderr, "Error reading file: %s (read %zu, expected %d)\n", 
-                filename, elements_read, size);
-        fclose(file);
-        exit(1);
-    }
-
-    fclose(file);
-}
-
-// --------------------------------------------------------
-// Scale factor 로드 함수
-// --------------------------------------------------------
-void load_scale(const char* filename, float* scale, int size) {
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) {
-        fprintf(stderr, "Error opening file: %s\n", filename);
-        exit(1);
-    }
-
-    size_t elements_read = fread(scale, sizeof(float), size, file);
-    if (elements_read != (size_t)size) {
-        fprintf(stderr, "Error reading file: %s (read %zu, expected %d)\n", 
-                filename, elements_read, size);
-        fclose(file);
-        exit(1);
-    }
-
-    fclose(file);
-}
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+};
 
-// --------------------------------------------------------
-// FP32 Reference Attention (검증용 - 표준 C 타입 사용)
-// --------------------------------------------------------
-void reference_attention_fp32(
-    int8_t Q[N][dk], int8_t K[N][dk], int8_t V[N][dv],
-    float Q_scale[N], float K_scale[N], float V_scale[N],
-    float Output_ref[N][dv]
-) {
-    float scale = 1.0f / sqrtf((float)dk);
-    
-    for (int i = 0; i < N; i++) {
-        // 1. Score 계산
-        float scores[N];
-        float max_val = -1e9;
+static const TestCase test_cases[] = {
+    { N,   dk, false },
+    { 17,  dk, false },
+    { 100, dk, false },
+    { 333, 48, false },
+    { 500, dk, false },
+    { N,   dk, true  },
+    { 17,  dk, true  },
+    { 333, 48, true  },
+};
 
-        for (int j = 0; j < N; j++) {
-            float sum = 0.0f;
-            for (int k = 0; k < dk; k++) {
-                float q_val = (float)Q[i][k] * Q_scale[i];
-                float k_val = (float)K[j][k] * K_scale[j];
-                sum += q_val * k_val;
-            }
-            scores[j] = sum * scale;
-            if (scores[j] > max_val) max_val = scores[j];
-        }
-        
-        // 2. Softmax
-        float sum_exp = 0.0f;
-        float P[N];
-        for (int j = 0; j < N; j++) {
-            P[j] = expf(scores[j] - max_val);
-            sum_exp += P[j];
-        }
-        
-        for (int j = 0; j < N; j++) {
-            P[j] /= sum_exp;
-        }
-        
-        // 3. Output Update
-        for (int d = 0; d < dv; d++) {
-            float sum_v = 0.0f;
-            for (int j = 0; j < N; j++) {
-                float v_val = (float)V[j][d] * V_scale[j];
-                sum_v += P[j] * v_val;
-            }
-            Output_ref[i][d] = sum_v;
-        }
-    }
-}
+// 실행할 backend (main 에서 인자로 선택, cpu_threads 0 = hardware_concurrency)
+static attention_options engine_options = { ATTN_BACKEND_HLS, 0 };
 
 // --------------------------------------------------------
-// Main
+// 테스트 1회 실행 - RMSE 반환
 // --------------------------------------------------------
-int main() {
+double run_test(AttentionEngine& engine, int seq_len, int head_dim, bool causal, const tensor_file* input) {
+    printf("==============================================\n");
+    printf("seq_len=%d, head_dim=%d, causal=%d (N=%d, dk=%d, dv=%d)\n",
+           seq_len, head_dim, (int)causal, N, dk, dv);
     printf("==============================================\n");
-    printf("Flash Attention INT8 Testbench (Fixed Type)\n");
-    printf("N=%d, dk=%d, dv=%d\n", N, dk, dv);
-    printf("==============================================\n\n");
 
     // --------------------------------------------------------
-    // 1. [검증용] 표준 C 타입 변수 선언 (int8_t)
+    // Host 버퍼 (pool - 두 번째 케이스부터는 재할당 없음)
+    // int8 Q/K/V 한 벌을 reference, cpu backend, HLS 커널 (qint8_view) 이 공유
     // --------------------------------------------------------
-    int8_t Q_ref[N][dk];
-    int8_t K_ref[N][dk];
-    int8_t V_ref[N][dv];
-    float Output_ref[N][dv];
+    attention_buffers buf;
+    attention_buffers_acquire(&buf);
 
-    // --------------------------------------------------------
-    // 2. [HLS용] HLS 전용 타입 변수 선언 (qint8_t / ap_int<8>)
-    // --------------------------------------------------------
-    qint8_t Q_hls[N][dk];
-    qint8_t K_hls[N][dk];
-    qint8_t V_hls[N][dv];
-    fixed_t Output_HLS[N][dv]; // 출력도 HLS 타입
+    int8_t (*Q)[dk] = buf.Q;
+    int8_t (*K)[dk] = buf.K;
+    int8_t (*V)[dv] = buf.V;
+    float* Q_scale = buf.scale_Q;
+    float* K_scale = buf.scale_K;
+    float* V_scale = buf.scale_V;
+    out_t (*Output_HLS)[dv] = buf.Output;       // cpu backend 도 out_t 로 변환해서 여기에
+    float (*Output_ref)[dv] = buf.Output_ref;
 
-    // Scales (공통)
-    float Q_scale[N];
-    float K_scale[N];
-    float V_scale[N];
-    
     // --------------------------------------------------------
     // 데이터 로드 또는 생성 (표준 C 타입 변수 사용)
+    // seq_len/head_dim 밖의 영역도 채워서 커널이 무시하는지 확인
     // --------------------------------------------------------
-    bool use_file = false;  // 파일이 있으면 true로 변경
-    
-    if (use_file) {
-        printf("Loading tensors from files...\n");
-        load_tensor_int8("Q_int8.bin", (int8_t*)Q_ref, N * dk);
-        load_tensor_int8("K_int8.bin", (int8_t*)K_ref, N * dk);
-        load_tensor_int8("V_int8.bin", (int8_t*)V_ref, N * dv);
-        load_scale("Q_scales.bin", Q_scale, N); 
-        load_scale("K_scales.bin", K_scale, N);
-        load_scale("V_scales.bin", V_scale, N);
+    if (input) {
+        // container 는 mmap 된 데이터를 그대로 사용 (PROT_READ - 커널은 Q/K/V/scale 을 읽기만 함)
+        printf("Using tensors from container (mmap)...\n");
+        Q = (int8_t (*)[dk])tensor_file_int8(input, "Q", N, dk);
+        K = (int8_t (*)[dk])tensor_file_int8(input, "K", N, dk);
+        V = (int8_t (*)[dv])tensor_file_int8(input, "V", N, dv);
+        Q_scale = (float*)tensor_file_fp32(input, "Q.scale", N);
+        K_scale = (float*)tensor_file_fp32(input, "K.scale", N);
+        V_scale = (float*)tensor_file_fp32(input, "V.scale", N);
     } else {
         printf("Generating random test data...\n");
         srand(42);
         
         for (int i = 0; i < N; i++) {
             for (int k = 0; k < dk; k++) {
-                Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
-                K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+                Q[i][k] = (int8_t)(rand() % 256 - 128);
+                K[i][k] = (int8_t)(rand() % 256 - 128);
             }
             for (int v = 0; v < dv; v++) {
-                V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+                V[i][v] = (int8_t)(rand() % 256 - 128);
             }
             
             Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
@@ -160,36 +97,40 @@ int main() {
         }
     }
 
-    // --------------------------------------------------------
-    // [중요] Ref 데이터 -> HLS 데이터로 복사 (형변환)
-    // --------------------------------------------------------
-    printf("Converting data types for HLS...\n");
+    // 출력만 초기화 (pool 버퍼는 이전 케이스 값이 남아 있음)
     for (int i = 0; i < N; i++) {
-        for (int k = 0; k < dk; k++) {
-            Q_hls[i][k] = Q_ref[i][k]; 
-            K_hls[i][k] = K_ref[i][k];
-        }
         for (int v = 0; v < dv; v++) {
-            V_hls[i][v] = V_ref[i][v];
             Output_HLS[i][v] = 0;
         }
+        buf.Output_scale[i] = 0.0f;
     }
 
     // --------------------------------------------------------
     // Reference 계산 (FP32)
     // --------------------------------------------------------
     printf("Computing reference attention (FP32)...\n");
-    reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref);
+    auto r_start = chrono::steady_clock::now();
+    reference_attention_fp32(Q, K, V, Q_scale, K_scale, V_scale, Output_ref,
+                             seq_len, head_dim, causal);
+    auto r_end = chrono::steady_clock::now();
+    double ref_ms = chrono::duration<double, milli>(r_end - r_start).count();
 
     // --------------------------------------------------------
-    // HLS 커널 호출 (수정됨: 인자 순서 변경)
+    // 커널 호출 (AttentionEngine - plan 후 execute)
     // --------------------------------------------------------
-    printf("Running HLS kernel...\n");
-    
-    // [수정 완료] Output_HLS를 4번째 인자로 넣었습니다.
-    // 기존: (Q, K, V, Q_scale, ..., Output) -> 에러
-    // 수정: (Q, K, V, Output, Q_scale, ...) -> 정상
-    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale);
+    attention_shape shape = { seq_len, head_dim, causal };
+    if (!engine.plan(shape, engine_options)) {
+        attention_buffers_release(&buf);
+        return 1e9;
+    }
+    if (engine_options.backend == ATTN_BACKEND_CPU) {
+        printf("Running CPU backend (%s)...\n", cpu_attention_isa());
+    } else {
+        printf("Running HLS kernel...\n");
+    }
+    ddr_stats.read_bytes = 0;
+    ddr_stats.write_bytes = 0;
+    double kernel_ms = engine.execute(Q, K, V, Q_scale, K_scale, V_scale, Output_HLS, buf.Output_scale);
 
     // --------------------------------------------------------
     // 결과 비교
@@ -200,10 +141,10 @@ int main() {
     double max_error = 0.0;
     int max_error_i = 0, max_error_d = 0;
     
-    for (int i = 0; i < N; i++) {
-        for (int d = 0; d < dv; d++) {
-            // HLS 결과(fixed_t)를 float으로 변환하여 비교
-            float hls_val = Output_HLS[i][d].to_float();
+    for (int i = 0; i < seq_len; i++) {
+        for (int d = 0; d < head_dim; d++) {
+            // HLS 결과(fixed_t, 또는 int8 dequant)를 float으로 변환하여 비교
+            float hls_val = output_value(buf.Output, buf.Output_scale, i, d);
             float ref_val = Output_ref[i][d];
             float error = hls_val - ref_val;
             
@@ -217,8 +158,19 @@ int main() {
         }
     }
     
-    mse /= (N * dv);
+    mse /= (seq_len * head_dim);
     double rmse = sqrt(mse);
+
+    // seq_len/head_dim 밖의 출력은 건드리지 않아야 함
+    int out_of_range_writes = 0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if ((i >= seq_len || d >= head_dim) && Output_HLS[i][d] != 0) {
+                out_of_range_writes++;
+            }
+        }
+        if (i >= seq_len && buf.Output_scale[i] != 0.0f) out_of_range_writes++;
+    }
     
     printf("\n==============================================\n");
     printf("Results:\n");
@@ -226,31 +178,173 @@ int main() {
     printf("MSE:        %.8f\n", mse);
     printf("RMSE:       %.8f\n", rmse);
     printf("Max Error:  %.8f at [%d][%d]\n", max_error, max_error_i, max_error_d);
-    printf("  HLS:  %.8f\n", Output_HLS[max_error_i][max_error_d].to_float());
+    printf("  HLS:  %.8f\n", output_value(buf.Output, buf.Output_scale, max_error_i, max_error_d));
     printf("  Ref:  %.8f\n", Output_ref[max_error_i][max_error_d]);
+    printf("Out-of-range writes: %d\n", out_of_range_writes);
+    if (engine_options.backend == ATTN_BACKEND_CPU) {
+        printf("Kernel time (cpu): %.3f ms, scalar reference: %.3f ms (%.1fx faster)\n",
+               kernel_ms, ref_ms, ref_ms / kernel_ms);
+    } else {
+        printf("Kernel time (csim): %.3f ms\n", kernel_ms);
+    }
+
+    // DDR 트래픽: 최소값 = Q/K/V + scale 을 한 번씩 읽는 양
+    unsigned long long min_read_bytes =
+        (unsigned long long)seq_len * (3 * head_dim * QINT8_BYTES + 3 * SCALE_BYTES);
+    printf("DDR read:   %llu bytes (%.2fx of minimum %llu)\n",
+           ddr_stats.read_bytes, (double)ddr_stats.read_bytes / min_read_bytes, min_read_bytes);
+    unsigned long long out_bytes = INT8_OUTPUT
+        ? (unsigned long long)seq_len * (head_dim * QINT8_BYTES + SCALE_BYTES)
+        : (unsigned long long)seq_len * head_dim * OUTPUT_BYTES;
+    printf("DDR write:  %llu bytes (output %llu)\n", ddr_stats.write_bytes, out_bytes);
     
     // 샘플 출력
     printf("\nSample outputs (first 5 rows, first 5 cols):\n");
     printf("%-12s %-12s %-12s\n", "HLS", "Reference", "Diff");
-    for (int i = 0; i < 5; i++) {
-        for (int d = 0; d < 5; d++) {
-            float hls_val = Output_HLS[i][d].to_float();
+    for (int i = 0; i < 5 && i < seq_len; i++) {
+        for (int d = 0; d < 5 && d < head_dim; d++) {
+            float hls_val = output_value(buf.Output, buf.Output_scale, i, d);
             float ref_val = Output_ref[i][d];
             printf("[%d][%d] %-10.6f %-10.6f %-10.6f\n", 
                    i, d, hls_val, ref_val, hls_val - ref_val);
         }
     }
+    printf("\n");
+
+    attention_buffers_release(&buf);
+
+    // 범위 밖 쓰기는 실패로 처리
+    return (out_of_range_writes == 0) ? rmse : 1e9;
+}
+
+// --------------------------------------------------------
+// submit() 확인 - 요청 3개를 비동기로 넣고 (다음 요청 데이터 준비와 겹침)
+// 각 결과가 같은 입력의 동기 execute() 결과와 bit 단위로 같은지
+// --------------------------------------------------------
+bool run_async_check(AttentionEngine& engine) {
+    const int num_requests = 3;
+    const int seq_len = 100;
+    attention_shape shape = { seq_len, dk, false };
+    if (!engine.plan(shape, engine_options)) return false;
+
+    printf("==============================================\n");
+    printf("Async submit: %d requests, seq_len=%d\n", num_requests, seq_len);
+    printf("==============================================\n");
+
+    attention_buffers req[num_requests];
+    std::future<double> pending[num_requests];
+    for (int n = 0; n < num_requests; n++) {
+        attention_buffers_acquire(&req[n]);
+        srand(100 + n);
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                req[n].Q[i][k] = (int8_t)(rand() % 256 - 128);
+                req[n].K[i][k] = (int8_t)(rand() % 256 - 128);
+            }
+            for (int v = 0; v < dv; v++) {
+                req[n].V[i][v] = (int8_t)(rand() % 256 - 128);
+                req[n].Output[i][v] = 0;
+            }
+            req[n].scale_Q[i] = 0.02f + (rand() % 100) * 0.0005f;
+            req[n].scale_K[i] = 0.02f + (rand() % 100) * 0.0005f;
+            req[n].scale_V[i] = 0.02f + (rand() % 100) * 0.0005f;
+        }
+        pending[n] = engine.submit(req[n].Q, req[n].K, req[n].V,
+                                   req[n].scale_Q, req[n].scale_K, req[n].scale_V,
+                                   req[n].Output, req[n].Output_scale);
+    }
+
+    attention_buffers sync;
+    attention_buffers_acquire(&sync);
+    int mismatches = 0;
+    for (int n = 0; n < num_requests; n++) {
+        double ms = pending[n].get();
+        engine.execute(req[n].Q, req[n].K, req[n].V,
+                       req[n].scale_Q, req[n].scale_K, req[n].scale_V,
+                       sync.Output, sync.Output_scale);
+        for (int i = 0; i < seq_len; i++) {
+            for (int v = 0; v < dk; v++) {
+                if (sync.Output[i][v] != req[n].Output[i][v]) mismatches++;
+            }
+            if (INT8_OUTPUT && sync.Output_scale[i] != req[n].Output_scale[i]) mismatches++;
+        }
+        printf("  request %d: %.3f ms\n", n, ms);
+    }
+    printf("Async vs sync mismatches: %d\n\n", mismatches);
+
+    attention_buffers_release(&sync);
+    for (int n = 0; n < num_requests; n++) {
+        attention_buffers_release(&req[n]);
+    }
+    return mismatches == 0;
+}
+
+// --------------------------------------------------------
+// Main
+// --------------------------------------------------------
+int main(int argc, char** argv) {
+    const char* input_path = NULL;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--backend=cpu") == 0) engine_options.backend = ATTN_BACKEND_CPU;
+        else if (strcmp(argv[a], "--backend=hls") == 0) engine_options.backend = ATTN_BACKEND_HLS;
+        else if (strncmp(argv[a], "--threads=", 10) == 0) engine_options.cpu_threads = atoi(argv[a] + 10);
+        else if (strncmp(argv[a], "--input=", 8) == 0) input_path = argv[a] + 8;
+        else {
+            fprintf(stderr, "Usage: %s [--backend=hls|cpu] [--threads=N] [--input=FILE.tfc]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("==============================================\n");
+    printf("Flash Attention INT8 Testbench (Fixed Type)\n");
+    printf("N=%d, dk=%d, dv=%d\n", N, dk, dv);
+    printf("Backend: %s\n", engine_options.backend == ATTN_BACKEND_CPU ? "cpu" : "hls");
+    printf("KV_RESIDENT_MAX=%d\n", KV_RESIDENT_MAX);
+    printf("P.V datapath: %s\n", INT8_PV ? "uint8 P x int8 V -> int32 (INT8_PV=1)" : "ap_fixed<32,16> P x int8 V");
+    printf("Output: %s\n", INT8_OUTPUT ? "int8 + per-row Output_scale (INT8_OUTPUT=1)" : "fixed_t (ap_fixed<16,5>)");
+    report_softmax_units();
+    printf("==============================================\n\n");
+
+    // 파일 입력 (N x dk 전체 길이만 지원) - shape / dtype 은 container header 로 검사
+    tensor_file input;
+    bool use_file = (input_path != NULL);
+    if (use_file) {
+        tensor_file_open(&input, input_path);
+        printf("Input: %s (%u tensors)\n\n", input_path, input.header->num_tensors);
+    }
+
+    AttentionEngine engine;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    double worst_rmse = 0.0;
+
+    for (int t = 0; t < num_cases; t++) {
+        // 파일 입력은 N x dk 고정 크기
+        if (use_file && (test_cases[t].seq_len != N || test_cases[t].head_dim != dk)) {
+            continue;
+        }
+        double rmse = run_test(engine, test_cases[t].seq_len, test_cases[t].head_dim,
+                               test_cases[t].causal, use_file ? &input : NULL);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+    if (use_file) tensor_file_close(&input);
+
+    // 비동기 결과가 다르면 실패
+    if (!run_async_check(engine)) worst_rmse = 1e9;
+    host_buffer_pool_trim();
     
-    // Pass/Fail 판정
-    printf("\n==============================================\n");
-    if (rmse < 0.1) {
+    // Pass/Fail 판정 (가장 나쁜 케이스 기준)
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
         printf("TEST PASSED (RMSE < 0.1)\n");
-    } else if (rmse < 0.5) {
+    } else if (worst_rmse < 0.5) {
         printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
     } else {
         printf("TEST FAILED (RMSE >= 0.5)\n");
     }
     printf("==============================================\n");
 
-    return (rmse < 0.5) ? 0 : 1;
-}
\ No newline at end of file
+    // INT8_PV 는 근사 datapath 라 MARGINAL 도 실패로 처리 (RMSE < 0.1 이어야 사용 가능)
+    double fail_rmse = INT8_PV ? 0.1 : 0.5;
+    return (worst_rmse < fail_rmse) ? 0 : 1;
+}
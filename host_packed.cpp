@@ -0,0 +1,206 @@
+// csim 소스: host_packed.cpp host_common.cpp top_flash_attention_violation_cleaned.cpp top_flash_attention_packed.cpp
+// violation_cleaned (원소 1개 / beat) 와 packed 128-bit 버전을 같은 입력으로 돌려서
+// 출력이 bit 단위로 같은지, AXI beat 수가 얼마나 줄었는지 비교
+#include "host_common.h"
+
+#if INT8_OUTPUT
+#error "host_packed compares fixed_t outputs bit-exactly; build with INT8_OUTPUT=0"
+#endif
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+using namespace std;
+
+// --------------------------------------------------------
+// 테스트 케이스 (seq_len, head_dim, causal)
+// head_dim=40 은 마지막 beat 가 일부 lane 만 유효한 경우
+// --------------------------------------------------------
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk, false },
+    { 100, dk, true  },
+    { 333, 48, false },
+    { 17,  40, true  },
+};
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static fixed_t Output_HLS[N][dv];
+
+// 128-bit packed 포트용
+static bus_t Q_bus[N][DK_BEATS];
+static bus_t K_bus[N][DK_BEATS];
+static bus_t V_bus[N][DV_BEATS];
+static bus_t Output_bus[N][DV_OUT_BEATS];
+
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+
+// --------------------------------------------------------
+// host 쪽 pack / unpack (커널 lane 배치와 동일)
+// --------------------------------------------------------
+static void pack_int8(qint8_t src[N][dk], bus_t dst[N][DK_BEATS]) {
+    for (int n = 0; n < N; n++) {
+        for (int b = 0; b < DK_BEATS; b++) {
+            bus_t beat = 0;
+            for (int l = 0; l < BUS_PACK_FACTOR; l++) {
+                beat.range(8 * l + 7, 8 * l) = src[n][b * BUS_PACK_FACTOR + l];
+            }
+            dst[n][b] = beat;
+        }
+    }
+}
+
+static fixed_t unpack_output(bus_t src[N][DV_OUT_BEATS], int n, int v) {
+    fixed_t val;
+    int l = v % OUT_PACK_FACTOR;
+    val.range(15, 0) = src[n][v / OUT_PACK_FACTOR].range(16 * l + 15, 16 * l);
+    return val;
+}
+
+// --------------------------------------------------------
+// 테스트 1회 실행 - packed 버전 RMSE 반환 (baseline 과 다르면 실패)
+// --------------------------------------------------------
+double run_test(int seq_len, int head_dim, bool causal) {
+    printf("==============================================\n");
+    printf("seq_len=%d, head_dim=%d, causal=%d\n", seq_len, head_dim, (int)causal);
+    printf("==============================================\n");
+
+    srand(42);
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+        }
+        for (int v = 0; v < dv; v++) {
+            V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+        }
+
+        Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+    }
+
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_hls[i][k] = Q_ref[i][k];
+            K_hls[i][k] = K_ref[i][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            V_hls[i][v] = V_ref[i][v];
+            Output_HLS[i][v] = 0;
+        }
+        for (int b = 0; b < DV_OUT_BEATS; b++) {
+            Output_bus[i][b] = 0;
+        }
+    }
+    pack_int8(Q_hls, Q_bus);
+    pack_int8(K_hls, K_bus);
+    pack_int8(V_hls, V_bus);
+
+    reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref,
+                             seq_len, head_dim, causal);
+
+    // --------------------------------------------------------
+    // Baseline (원소 1개 / beat)
+    // --------------------------------------------------------
+    ddr_stats = ddr_stats_t();
+    auto t0 = chrono::steady_clock::now();
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale,
+                          seq_len, head_dim, causal);
+    auto t1 = chrono::steady_clock::now();
+    ddr_stats_t base = ddr_stats;
+
+    // --------------------------------------------------------
+    // Packed 128-bit
+    // --------------------------------------------------------
+    ddr_stats = ddr_stats_t();
+    auto t2 = chrono::steady_clock::now();
+    compute_attention_packed_HLS(Q_bus, K_bus, V_bus, Output_bus, Q_scale, K_scale, V_scale,
+                                 seq_len, head_dim, causal);
+    auto t3 = chrono::steady_clock::now();
+    ddr_stats_t packed = ddr_stats;
+
+    // --------------------------------------------------------
+    // 결과 비교
+    // --------------------------------------------------------
+    double mse = 0.0;
+    double max_error = 0.0;
+    int mismatches = 0;
+    int out_of_range_writes = 0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            fixed_t val = unpack_output(Output_bus, i, d);
+            if (i < seq_len && d < head_dim) {
+                if (val != Output_HLS[i][d]) mismatches++;
+                float error = val.to_float() - Output_ref[i][d];
+                mse += error * error;
+                if (fabs(error) > max_error) max_error = fabs(error);
+            } else if (val != 0) {
+                out_of_range_writes++;
+            }
+        }
+    }
+    mse /= (seq_len * head_dim);
+    double rmse = sqrt(mse);
+
+    printf("RMSE:       %.8f  Max Error: %.8f\n", rmse, max_error);
+    printf("Mismatches vs baseline: %d, out-of-range writes: %d\n", mismatches, out_of_range_writes);
+    // scale 포트는 두 버전 모두 float 1개 / beat 라 read 비율은 16x 보다 약간 작음
+    printf("Read beats:  baseline %llu -> packed %llu (%.2fx fewer)\n",
+           base.read_beats, packed.read_beats, (double)base.read_beats / packed.read_beats);
+    printf("Write beats: baseline %llu -> packed %llu (%.2fx fewer)\n",
+           base.write_beats, packed.write_beats, (double)base.write_beats / packed.write_beats);
+    printf("Kernel time (csim): baseline %.3f ms, packed %.3f ms\n\n",
+           chrono::duration<double, milli>(t1 - t0).count(),
+           chrono::duration<double, milli>(t3 - t2).count());
+
+    return (mismatches == 0 && out_of_range_writes == 0) ? rmse : 1e9;
+}
+
+// --------------------------------------------------------
+// Main
+// --------------------------------------------------------
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention INT8 Packed 128-bit Testbench\n");
+    printf("N=%d, dk=%d, dv=%d, BUS_BITS=%d (int8 x%d, fixed_t x%d per beat)\n",
+           N, dk, dv, BUS_BITS, BUS_PACK_FACTOR, OUT_PACK_FACTOR);
+    report_softmax_units();
+    printf("==============================================\n\n");
+
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    double worst_rmse = 0.0;
+
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_test(test_cases[t].seq_len, test_cases[t].head_dim, test_cases[t].causal);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
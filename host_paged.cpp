@@ -0,0 +1,242 @@
+// csim 소스: host_paged.cpp host_common.cpp top_flash_attention_paged.cpp top_flash_attention_DATAFLOW.cpp
+// paged KV variant 를 연속 K/V 의 DATAFLOW variant 와 같은 입력으로 비교
+//   - 시퀀스 NUM_SEQS 개가 pool 하나를 공유, page 는 섞인 순서로 할당 (block table 이 연속이 아님)
+//   - 할당 안 된 page 는 쓰레기 값 - 다른 page 를 잘못 읽으면 결과가 달라짐
+//   - 시퀀스마다 paged 출력이 연속 K/V 출력과 bit 단위로 같아야 함 + fp32 reference RMSE
+//   - pool 밖 page index 는 page 0 으로 읽어야 함 (pool 밖 주소 접근 없음)
+#include "host_common.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk, false },
+    { N,   dk, true  },
+    { 333, 48, false },
+    { 100, dk, true  },
+    { 17,  dk, false },
+};
+
+// pool 을 공유하는 시퀀스 수 (NUM_SEQS * KV_MAX_PAGES <= KV_POOL_PAGES)
+#define NUM_SEQS 2
+static_assert(NUM_SEQS * KV_MAX_PAGES <= KV_POOL_PAGES, "pool too small for NUM_SEQS");
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+
+static qint8_t K_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dk];
+static qint8_t V_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dv];
+static float scale_K_pool[KV_POOL_PAGES][KV_PAGE_ROWS];
+static float scale_V_pool[KV_POOL_PAGES][KV_PAGE_ROWS];
+static int block_table[NUM_SEQS][KV_MAX_PAGES];
+
+static out_t Output_contig[N][dv];
+static float Output_contig_scale[N];
+static out_t Output_paged[N][dv];
+static float Output_paged_scale[N];
+
+// --------------------------------------------------------
+// pool 초기화 - 전부 쓰레기 값, page 순서를 섞어서 시퀀스별 block table 할당
+// --------------------------------------------------------
+static void init_pool(unsigned seed) {
+    srand(seed);
+    for (int p = 0; p < KV_POOL_PAGES; p++) {
+        for (int r = 0; r < KV_PAGE_ROWS; r++) {
+            for (int k = 0; k < dk; k++) K_pool[p][r][k] = (qint8_t)(rand() % 256 - 128);
+            for (int v = 0; v < dv; v++) V_pool[p][r][v] = (qint8_t)(rand() % 256 - 128);
+            scale_K_pool[p][r] = 1.0f;
+            scale_V_pool[p][r] = 1.0f;
+        }
+    }
+
+    int order[KV_POOL_PAGES];
+    for (int p = 0; p < KV_POOL_PAGES; p++) order[p] = p;
+    for (int p = KV_POOL_PAGES - 1; p > 0; p--) swap(order[p], order[rand() % (p + 1)]);
+
+    for (int s = 0; s < NUM_SEQS; s++) {
+        for (int p = 0; p < KV_MAX_PAGES; p++) {
+            block_table[s][p] = order[s * KV_MAX_PAGES + p];
+        }
+    }
+}
+
+// 시퀀스 s 의 연속 K/V 를 자기 page 에 scatter (serving 에서 KV cache append 에 해당)
+static void scatter_to_pages(int s, int seq_len) {
+    for (int r = 0; r < seq_len; r++) {
+        int page = block_table[s][r / KV_PAGE_ROWS];
+        int off = r % KV_PAGE_ROWS;
+        for (int k = 0; k < dk; k++) K_pool[page][off][k] = K_hls[r][k];
+        for (int v = 0; v < dv; v++) V_pool[page][off][v] = V_hls[r][v];
+        scale_K_pool[page][off] = K_scale[r];
+        scale_V_pool[page][off] = V_scale[r];
+    }
+}
+
+// --------------------------------------------------------
+// 테스트 1회 - 시퀀스마다 다른 입력, paged vs 연속 비교, 가장 나쁜 RMSE 반환
+// --------------------------------------------------------
+static double run_test(int seq_len, int head_dim, bool causal) {
+    printf("==============================================\n");
+    printf("seq_len=%d, head_dim=%d, causal=%d\n", seq_len, head_dim, (int)causal);
+    printf("==============================================\n");
+
+    init_pool(7);
+
+    double worst = 0.0;
+    for (int s = 0; s < NUM_SEQS; s++) {
+        srand(42 + s);
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < dk; k++) {
+                Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+                K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+                Q_hls[i][k] = Q_ref[i][k];
+                K_hls[i][k] = K_ref[i][k];
+            }
+            for (int v = 0; v < dv; v++) {
+                V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+                V_hls[i][v] = V_ref[i][v];
+                Output_contig[i][v] = 0;
+                Output_paged[i][v] = 0;
+            }
+            Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+            K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+            V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+            Output_contig_scale[i] = 0.0f;
+            Output_paged_scale[i] = 0.0f;
+        }
+        scatter_to_pages(s, seq_len);
+
+        reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref,
+                                 seq_len, head_dim, causal);
+
+        // 연속 K/V (DATAFLOW variant)
+        ddr_stats = ddr_stats_t();
+        compute_attention_HLS(Q_hls, K_hls, V_hls, Output_contig, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                              Output_contig_scale,
+#endif
+                              seq_len, head_dim, causal);
+        unsigned long long contig_read = ddr_stats.read_bytes;
+
+        // paged K/V - pool 에서 직접
+        ddr_stats = ddr_stats_t();
+        compute_attention_paged_HLS(Q_hls, K_pool, V_pool, Output_paged, Q_scale, scale_K_pool, scale_V_pool,
+#if INT8_OUTPUT
+                                    Output_paged_scale,
+#endif
+                                    block_table[s], seq_len, head_dim, causal);
+        unsigned long long paged_read = ddr_stats.read_bytes;
+
+        int mismatches = 0, out_of_range_writes = 0;
+        double mse = 0.0;
+        for (int i = 0; i < N; i++) {
+            for (int d = 0; d < dv; d++) {
+                bool in_range = (i < seq_len && d < head_dim);
+                if (!in_range) {
+                    if (Output_paged[i][d] != 0) out_of_range_writes++;
+                    continue;
+                }
+                if (Output_paged[i][d] != Output_contig[i][d]) mismatches++;
+                double error = output_value(Output_paged, Output_paged_scale, i, d) - Output_ref[i][d];
+                mse += error * error;
+            }
+#if INT8_OUTPUT
+            if (i < seq_len && Output_paged_scale[i] != Output_contig_scale[i]) mismatches++;
+            if (i >= seq_len && Output_paged_scale[i] != 0.0f) out_of_range_writes++;
+#endif
+        }
+        double rmse = sqrt(mse / (seq_len * head_dim));
+
+        printf("seq %d (first page %2d): RMSE %.8f, vs contiguous: %d values differ, oor %d, "
+               "DDR read paged %llu / contiguous %llu bytes\n",
+               s, block_table[s][0], rmse, mismatches, out_of_range_writes, paged_read, contig_read);
+
+        // paged 는 주소만 다르고 datapath 는 같음 - bit 단위로 같아야 함
+        if (mismatches != 0 || out_of_range_writes != 0) rmse = 1e9;
+        if (rmse > worst) worst = rmse;
+    }
+    printf("\n");
+    return worst;
+}
+
+// --------------------------------------------------------
+// pool 밖 page index (음수, KV_POOL_PAGES 이상) - page 0 으로 바꾼 block table 과 bit 단위로 같아야 함
+// 반환: 다른 값 수
+// --------------------------------------------------------
+static int check_bad_block_table() {
+    static const int bad_pages[] = { -1, KV_POOL_PAGES, KV_POOL_PAGES + 7, -KV_POOL_PAGES };
+    const int num_bad = sizeof(bad_pages) / sizeof(bad_pages[0]);
+    int bad_table[KV_MAX_PAGES], fixed_table[KV_MAX_PAGES];
+    for (int p = 0; p < KV_MAX_PAGES; p++) {
+        bool bad = (p % 2 == 1);
+        bad_table[p] = bad ? bad_pages[(p / 2) % num_bad] : block_table[0][p];
+        fixed_table[p] = bad ? 0 : block_table[0][p];
+    }
+
+    compute_attention_paged_HLS(Q_hls, K_pool, V_pool, Output_contig, Q_scale, scale_K_pool, scale_V_pool,
+#if INT8_OUTPUT
+                                Output_contig_scale,
+#endif
+                                fixed_table, N, dk, false);
+    compute_attention_paged_HLS(Q_hls, K_pool, V_pool, Output_paged, Q_scale, scale_K_pool, scale_V_pool,
+#if INT8_OUTPUT
+                                Output_paged_scale,
+#endif
+                                bad_table, N, dk, false);
+
+    int mismatches = 0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if (Output_paged[i][d] != Output_contig[i][d]) mismatches++;
+        }
+    }
+    printf("out-of-pool page index -> page 0: %d values differ\n\n", mismatches);
+    return mismatches;
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention paged KV testbench\n");
+    printf("N=%d, dk=%d, dv=%d, Bc=%d, KV_PAGE_ROWS=%d, KV_POOL_PAGES=%d, KV_RESIDENT_MAX=%d\n",
+           N, dk, dv, Bc, KV_PAGE_ROWS, KV_POOL_PAGES, KV_RESIDENT_MAX);
+    printf("==============================================\n\n");
+
+    double worst_rmse = 0.0;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_test(test_cases[t].seq_len, test_cases[t].head_dim, test_cases[t].causal);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+    if (check_bad_block_table() != 0) worst_rmse = 1e9;
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+// csim 소스: host_quant.cpp host_common.cpp top_flash_attention_quant.cpp top_flash_attention_DATAFLOW.cpp
+// fused 양자화 variant (compute_attention_quant_HLS) 검증
+//   1. Q/K/V_tensor.bin (fixed_t 활성값) 을 바로 입력 -> Output_tensor.bin 과 비교
+//      같은 데이터의 offline 양자화 경로 (*_int8.bin + *_scales.bin, DATAFLOW variant) 와 정확도 / DDR 트래픽 비교
+//   2. random 활성값, seq_len / head_dim / causal 조합 -> 활성값 fp reference 와 비교
+#include "host_common.h"
+
+#if INT8_OUTPUT
+#error "host_quant compares against the fixed_t DATAFLOW output; build with INT8_OUTPUT=0"
+#endif
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk, false },
+    { 17,  dk, false },
+    { 333, 48, false },
+    { N,   dk, true  },
+    { 333, 48, true  },
+};
+
+static fixed_t Q_act[N][dk];
+static fixed_t K_act[N][dk];
+static fixed_t V_act[N][dv];
+static fixed_t Output_expected[N][dv];  // Output_tensor.bin
+static fixed_t Output_HLS[N][dv];
+static float Output_ref[N][dv];
+
+// offline 양자화 경로 입력
+static int8_t Q_i8[N][dk];
+static int8_t K_i8[N][dk];
+static int8_t V_i8[N][dv];
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+
+// --------------------------------------------------------
+// 활성값 (양자화 전) 기준 fp reference
+// --------------------------------------------------------
+static void reference_attention_act(int seq_len, int head_dim, bool causal) {
+    float scale = 1.0f / sqrtf((float)head_dim);
+
+    for (int i = 0; i < seq_len; i++) {
+        int kv_len = causal ? i + 1 : seq_len;
+
+        float scores[N];
+        float max_val = -1e9;
+        for (int j = 0; j < kv_len; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < head_dim; k++) {
+                sum += Q_act[i][k].to_float() * K_act[j][k].to_float();
+            }
+            scores[j] = sum * scale;
+            if (scores[j] > max_val) max_val = scores[j];
+        }
+
+        float sum_exp = 0.0f;
+        for (int j = 0; j < kv_len; j++) {
+            scores[j] = expf(scores[j] - max_val);
+            sum_exp += scores[j];
+        }
+
+        for (int d = 0; d < head_dim; d++) {
+            float sum_v = 0.0f;
+            for (int j = 0; j < kv_len; j++) {
+                sum_v += scores[j] * V_act[j][d].to_float();
+            }
+            Output_ref[i][d] = sum_v / sum_exp;
+        }
+    }
+}
+
+static double rmse_vs_float(fixed_t out[N][dv], float ref[N][dv], int seq_len, int head_dim, double* max_error) {
+    double mse = 0.0;
+    *max_error = 0.0;
+    for (int i = 0; i < seq_len; i++) {
+        for (int d = 0; d < head_dim; d++) {
+            double error = out[i][d].to_double() - ref[i][d];
+            mse += error * error;
+            if (fabs(error) > *max_error) *max_error = fabs(error);
+        }
+    }
+    return sqrt(mse / (seq_len * head_dim));
+}
+
+static void clear_output() {
+    for (int i = 0; i < N; i++) {
+        for (int v = 0; v < dv; v++) {
+            Output_HLS[i][v] = 0;
+        }
+    }
+}
+
+// --------------------------------------------------------
+// 1. 저장된 활성값 - fused vs offline 양자화
+// --------------------------------------------------------
+static double run_file_test() {
+    printf("==============================================\n");
+    printf("File input: Q/K/V_tensor.bin -> Output_tensor.bin (seq_len=%d, head_dim=%d)\n", N, dk);
+    printf("==============================================\n");
+
+    load_tensor_fixed("Q_tensor.bin", (fixed_t*)Q_act, N * dk);
+    load_tensor_fixed("K_tensor.bin", (fixed_t*)K_act, N * dk);
+    load_tensor_fixed("V_tensor.bin", (fixed_t*)V_act, N * dv);
+    load_tensor_fixed("Output_tensor.bin", (fixed_t*)Output_expected, N * dv);
+    load_tensor_int8("Q_int8.bin", (int8_t*)Q_i8, N * dk);
+    load_tensor_int8("K_int8.bin", (int8_t*)K_i8, N * dk);
+    load_tensor_int8("V_int8.bin", (int8_t*)V_i8, N * dv);
+    load_scale("Q_scales.bin", Q_scale, N);
+    load_scale("K_scales.bin", K_scale, N);
+    load_scale("V_scales.bin", V_scale, N);
+
+    // 커널 양자화기 (quant_row) vs offline int8 - 값 차이 분포
+    int q_mismatch = 0, q_max_diff = 0;
+    for (int i = 0; i < N; i++) {
+        qint8_t q[dk];
+        quant_row<dk>(Q_act[i], dk, q);
+        for (int k = 0; k < dk; k++) {
+            int diff = abs((int)q[k] - (int)Q_i8[i][k]);
+            if (diff) q_mismatch++;
+            if (diff > q_max_diff) q_max_diff = diff;
+        }
+    }
+    printf("quant_row vs Q_int8.bin: %d / %d values differ (max %d LSB)\n", q_mismatch, N * dk, q_max_diff);
+
+    for (int i = 0; i < N; i++) {
+        for (int e = 0; e < dk; e++) {
+            Output_ref[i][e] = Output_expected[i][e].to_float();
+        }
+    }
+
+    // fused
+    clear_output();
+    ddr_stats.read_bytes = 0;
+    ddr_stats.write_bytes = 0;
+    compute_attention_quant_HLS(Q_act, K_act, V_act, Output_HLS, N, dk, false);
+    unsigned long long fused_read = ddr_stats.read_bytes;
+    double fused_max;
+    double fused_rmse = rmse_vs_float(Output_HLS, Output_ref, N, dk, &fused_max);
+
+    // offline 양자화 + DATAFLOW
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_hls[i][k] = Q_i8[i][k];
+            K_hls[i][k] = K_i8[i][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            V_hls[i][v] = V_i8[i][v];
+        }
+    }
+    clear_output();
+    ddr_stats.read_bytes = 0;
+    ddr_stats.write_bytes = 0;
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale, N, dk, false);
+    unsigned long long kernel_read = ddr_stats.read_bytes;
+    double offline_max;
+    double offline_rmse = rmse_vs_float(Output_HLS, Output_ref, N, dk, &offline_max);
+
+    // offline 양자화 pass: fixed_t 읽기 + int8 / scale 쓰기
+    unsigned long long pass_read = (unsigned long long)N * 3 * dk * ACT_BYTES;
+    unsigned long long pass_write = (unsigned long long)N * 3 * (dk * QINT8_BYTES + SCALE_BYTES);
+
+    printf("Fused   vs Output_tensor.bin: RMSE %.8f, max error %.8f\n", fused_rmse, fused_max);
+    printf("Offline vs Output_tensor.bin: RMSE %.8f, max error %.8f\n", offline_rmse, offline_max);
+    printf("DDR (Q/K/V 입력 측): fused read %llu bytes | offline quant pass read %llu + write %llu + kernel read %llu = %llu bytes\n\n",
+           fused_read, pass_read, pass_write, kernel_read, pass_read + pass_write + kernel_read);
+    return fused_rmse;
+}
+
+// --------------------------------------------------------
+// 2. random 활성값 - 행마다 크기가 다르게 (per-row scale 이 의미 있도록)
+// --------------------------------------------------------
+static double run_random_test(int seq_len, int head_dim, bool causal) {
+    printf("==============================================\n");
+    printf("Random activations: seq_len=%d, head_dim=%d, causal=%d\n", seq_len, head_dim, (int)causal);
+    printf("==============================================\n");
+
+    srand(42);
+    for (int i = 0; i < N; i++) {
+        float q_amp = 0.25f + (rand() % 100) * 0.01f;
+        float k_amp = 0.25f + (rand() % 100) * 0.01f;
+        float v_amp = 0.25f + (rand() % 100) * 0.03f;
+        for (int k = 0; k < dk; k++) {
+            Q_act[i][k] = (fixed_t)(q_amp * ((rand() % 2001) - 1000) / 1000.0f);
+            K_act[i][k] = (fixed_t)(k_amp * ((rand() % 2001) - 1000) / 1000.0f);
+        }
+        for (int v = 0; v < dv; v++) {
+            V_act[i][v] = (fixed_t)(v_amp * ((rand() % 2001) - 1000) / 1000.0f);
+        }
+    }
+    // 전부 0 인 행 (absmax == 0 경로)
+    for (int k = 0; k < dk; k++) {
+        K_act[3][k] = 0;
+    }
+
+    reference_attention_act(seq_len, head_dim, causal);
+
+    clear_output();
+    ddr_stats.read_bytes = 0;
+    ddr_stats.write_bytes = 0;
+    compute_attention_quant_HLS(Q_act, K_act, V_act, Output_HLS, seq_len, head_dim, causal);
+
+    double max_error;
+    double rmse = rmse_vs_float(Output_HLS, Output_ref, seq_len, head_dim, &max_error);
+
+    int out_of_range_writes = 0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if ((i >= seq_len || d >= head_dim) && Output_HLS[i][d] != 0) {
+                out_of_range_writes++;
+            }
+        }
+    }
+
+    unsigned long long min_read_bytes = (unsigned long long)seq_len * 3 * head_dim * ACT_BYTES;
+    printf("RMSE:       %.8f\n", rmse);
+    printf("Max Error:  %.8f\n", max_error);
+    printf("Out-of-range writes: %d\n", out_of_range_writes);
+    printf("DDR read:   %llu bytes (%.2fx of minimum %llu)\n\n",
+           ddr_stats.read_bytes, (double)ddr_stats.read_bytes / min_read_bytes, min_read_bytes);
+
+    return (out_of_range_writes == 0) ? rmse : 1e9;
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention fused quantization testbench\n");
+    printf("N=%d, dk=%d, dv=%d, KV_RESIDENT_MAX=%d\n", N, dk, dv, KV_RESIDENT_MAX);
+    printf("==============================================\n\n");
+
+    double worst_rmse = run_file_test();
+
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_random_test(test_cases[t].seq_len, test_cases[t].head_dim, test_cases[t].causal);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
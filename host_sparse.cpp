@@ -0,0 +1,277 @@
+// csim 소스: host_sparse.cpp host_common.cpp top_flash_attention_DATAFLOW.cpp (또는 _typecasting_doublebuffer.cpp)
+// -DBLOCK_SPARSE=1 로 빌드
+// 고정 sparse 패턴 (dense / local + global / strided / 빈 타일) 의 블록 CSR 을 만들어서
+//   - 같은 블록 mask 를 적용한 fp32 reference 와 비교 (active 블록이 없는 행은 0)
+//   - active 블록 수와 시간 / DDR 트래픽을 dense 패턴과 비교 (지연이 active 블록 수에 비례하는지)
+//   - CSR 포인터가 SPARSE_MAX_BLOCKS 를 넘으면 잘려야 함 (kv_block_idx 밖을 읽지 않음)
+#include "host_common.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if !BLOCK_SPARSE
+#error "host_sparse needs the block-sparse kernel ports; build with BLOCK_SPARSE=1"
+#endif
+
+using namespace std;
+
+enum sparse_pattern {
+    PATTERN_DENSE,          // 전부 (causal 이면 대각까지) - 기존 커널과 같은 결과
+    PATTERN_LOCAL_GLOBAL,   // 블록 0 (global 토큰) + 대각 주변 +-LOCAL_BLOCKS
+    PATTERN_STRIDED,        // 대각 블록 + 대각에서 STRIDE_BLOCKS 간격
+    PATTERN_EMPTY_TILES,    // local + global, 홀수 Q 타일은 블록 0 개 (출력 0)
+};
+
+static const char* pattern_name[] = { "dense", "local+global", "strided", "empty tiles" };
+
+#define LOCAL_BLOCKS  1
+#define STRIDE_BLOCKS 4
+
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+    sparse_pattern pattern;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk, false, PATTERN_DENSE        },
+    { N,   dk, false, PATTERN_LOCAL_GLOBAL },
+    { N,   dk, false, PATTERN_STRIDED      },
+    { N,   dk, true,  PATTERN_DENSE        },
+    { N,   dk, true,  PATTERN_LOCAL_GLOBAL },
+    { N,   dk, true,  PATTERN_STRIDED      },
+    { 333, 48, true,  PATTERN_LOCAL_GLOBAL },
+    { 200, dk, false, PATTERN_EMPTY_TILES  },
+    { 17,  dk, false, PATTERN_LOCAL_GLOBAL },
+};
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+static out_t Output_HLS[N][dv];
+static float Output_scale[N];
+
+static int kv_block_ptr[SPARSE_Q_TILES + 1];
+static int kv_block_idx[SPARSE_MAX_BLOCKS];
+static out_t Output_dense[N][dv];
+static bool block_active[SPARSE_Q_TILES][N / Bc];
+
+// --------------------------------------------------------
+// 패턴 -> CSR (블록 번호 오름차순, causal 이면 대각 블록까지만)
+// 반환: active 블록 수
+// --------------------------------------------------------
+static int build_block_list(sparse_pattern pattern, int seq_len, bool causal) {
+    int num_q_tiles = (seq_len + Br - 1) / Br;
+    int n = 0;
+    for (int t = 0; t < num_q_tiles; t++) {
+        kv_block_ptr[t] = n;
+        int num_kv_blocks = (kv_range_end(t * Br, seq_len, causal) + Bc - 1) / Bc;
+        int diag = (t * Br) / Bc;
+        for (int jb = 0; jb < N / Bc; jb++) {
+            bool on;
+            switch (pattern) {
+            case PATTERN_DENSE:
+                on = true;
+                break;
+            case PATTERN_STRIDED:
+                on = (jb == diag) || (abs(diag - jb) % STRIDE_BLOCKS == 0);
+                break;
+            case PATTERN_EMPTY_TILES:
+                on = (t % 2 == 0) && (jb == 0 || abs(diag - jb) <= LOCAL_BLOCKS);
+                break;
+            default:
+                on = (jb == 0 || abs(diag - jb) <= LOCAL_BLOCKS);
+                break;
+            }
+            on = on && (jb < num_kv_blocks);
+            block_active[t][jb] = on;
+            if (on) kv_block_idx[n++] = jb;
+        }
+    }
+    kv_block_ptr[num_q_tiles] = n;
+    return n;
+}
+
+// --------------------------------------------------------
+// block mask 를 적용한 FP32 reference (active key 가 없는 행은 0)
+// --------------------------------------------------------
+static void reference_attention_sparse(int seq_len, int head_dim, bool causal) {
+    float scale = 1.0f / sqrtf((float)head_dim);
+    static float scores[N];
+    static bool key_on[N];
+
+    for (int i = 0; i < seq_len; i++) {
+        float max_val = -1e9;
+        int num_keys = 0;
+        for (int j = 0; j < seq_len; j++) {
+            key_on[j] = block_active[i / Br][j / Bc] && !(causal && j > i);
+            if (!key_on[j]) continue;
+            int sum = 0;
+            for (int k = 0; k < head_dim; k++) {
+                sum += (int)Q_ref[i][k] * (int)K_ref[j][k];
+            }
+            scores[j] = sum * Q_scale[i] * K_scale[j] * scale;
+            if (scores[j] > max_val) max_val = scores[j];
+            num_keys++;
+        }
+
+        float sum_exp = 0.0f;
+        for (int j = 0; j < seq_len; j++) {
+            if (!key_on[j]) continue;
+            scores[j] = expf(scores[j] - max_val);
+            sum_exp += scores[j];
+        }
+
+        for (int d = 0; d < head_dim; d++) {
+            float sum_v = 0.0f;
+            for (int j = 0; j < seq_len; j++) {
+                if (key_on[j]) sum_v += scores[j] * V_ref[j][d] * V_scale[j];
+            }
+            Output_ref[i][d] = (num_keys > 0) ? sum_v / sum_exp : 0.0f;
+        }
+    }
+}
+
+// --------------------------------------------------------
+// 테스트 1회 - RMSE 반환 (범위 밖 쓰기는 실패)
+// --------------------------------------------------------
+static double run_test(const TestCase& tc, double* dense_ms) {
+    srand(42);
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            Q_hls[i][k] = Q_ref[i][k];
+            K_hls[i][k] = K_ref[i][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+            V_hls[i][v] = V_ref[i][v];
+            Output_HLS[i][v] = 0;
+        }
+        Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        Output_scale[i] = 0.0f;
+    }
+
+    int active = build_block_list(tc.pattern, tc.seq_len, tc.causal);
+    reference_attention_sparse(tc.seq_len, tc.head_dim, tc.causal);
+
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_scale,
+#endif
+                          kv_block_ptr, kv_block_idx, tc.seq_len, tc.head_dim, tc.causal);
+    auto t_end = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t_end - t_start).count();
+
+    double mse = 0.0, max_error = 0.0;
+    int out_of_range_writes = 0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if (i >= tc.seq_len || d >= tc.head_dim) {
+                if (Output_HLS[i][d] != 0) out_of_range_writes++;
+                continue;
+            }
+#if INT8_OUTPUT
+            double out = Output_HLS[i][d].to_int() * (double)Output_scale[i];
+#else
+            double out = Output_HLS[i][d].to_double();
+#endif
+            double error = out - Output_ref[i][d];
+            mse += error * error;
+            if (fabs(error) > max_error) max_error = fabs(error);
+        }
+    }
+    double rmse = sqrt(mse / (tc.seq_len * tc.head_dim));
+
+    // 같은 shape 의 dense 패턴 기준 시간 비율
+    if (tc.pattern == PATTERN_DENSE) *dense_ms = ms;
+    printf("%-12s seq_len=%3d head_dim=%2d causal=%d | blocks %3d | RMSE %.8f  max %.8f  oor %d | "
+           "%8.3f ms", pattern_name[tc.pattern], tc.seq_len, tc.head_dim, (int)tc.causal, active,
+           rmse, max_error, out_of_range_writes, ms);
+    if (*dense_ms > 0.0) printf(" (%.2fx dense)", ms / *dense_ms);
+    printf(", DDR read %llu\n", ddr_stats.read_bytes);
+
+    return (out_of_range_writes == 0) ? rmse : 1e9;
+}
+
+// --------------------------------------------------------
+// 잘못된 CSR - 마지막 포인터 (전체 블록 수) 가 SPARSE_MAX_BLOCKS 를 넘음 (dense, seq_len = N)
+// SPARSE_MAX_BLOCKS 로 잘리면 원래 dense 목록과 같음 -> bit 단위로 같아야 함
+// 반환: 다른 값 수
+// --------------------------------------------------------
+static int check_oversized_block_ptr() {
+    const int num_q_tiles = N / Br;
+    build_block_list(PATTERN_DENSE, N, false);
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_dense, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_scale,
+#endif
+                          kv_block_ptr, kv_block_idx, N, dk, false);
+
+    kv_block_ptr[num_q_tiles] = SPARSE_MAX_BLOCKS + 100000;
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_HLS, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_scale,
+#endif
+                          kv_block_ptr, kv_block_idx, N, dk, false);
+
+    int mismatches = 0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if (Output_HLS[i][d] != Output_dense[i][d]) mismatches++;
+        }
+    }
+    printf("block ptr past SPARSE_MAX_BLOCKS: %d values differ\n", mismatches);
+    return mismatches;
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention block-sparse testbench\n");
+    printf("N=%d, Br=%d, Bc=%d, KV_RESIDENT_MAX=%d, INT8_OUTPUT=%d, LOCAL_BLOCKS=%d, STRIDE_BLOCKS=%d\n",
+           N, Br, Bc, KV_RESIDENT_MAX, INT8_OUTPUT, LOCAL_BLOCKS, STRIDE_BLOCKS);
+    printf("==============================================\n");
+
+    double worst_rmse = 0.0;
+    double dense_ms = 0.0;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        const TestCase& tc = test_cases[t];
+        // shape 가 바뀌면 dense 기준 없음
+        if (t > 0 && (tc.seq_len != test_cases[t - 1].seq_len || tc.head_dim != test_cases[t - 1].head_dim ||
+                      tc.causal != test_cases[t - 1].causal)) {
+            dense_ms = 0.0;
+        }
+        double rmse = run_test(tc, &dense_ms);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+    if (check_oversized_block_ptr() != 0) worst_rmse = 1e9;
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+// csim 소스: host_splitkv.cpp host_common.cpp top_flash_attention_splitkv.cpp top_flash_attention_DATAFLOW.cpp
+// split-KV (청크별 partial + logsumexp combine) 를 단일 패스 DATAFLOW variant 와 같은 입력으로 비교
+//   - 청크마다 thread 하나 (= compute unit 하나) 로 compute_attention_splitkv_HLS 동시 실행
+//   - num_splits == 1 은 단일 패스와 bit 단위로 같아야 함
+//   - 그 외는 단일 패스 대비 차이 / fp32 reference RMSE / 청크별 DDR 트래픽 출력
+//   - Q 범위 [q_start, q_start + q_len) 만 계산 (decode = 마지막 행 하나), 범위 밖 행은 쓰지 않아야 함
+//   - combine 의 num_splits > MAX_KV_SPLITS 는 MAX_KV_SPLITS 로 잘림, 0 이하는 출력 없음
+#include "host_common.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+    int q_start;
+    int q_len;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk, false, 0,     N   },
+    { N,   dk, true,  0,     N   },
+    { 333, 48, false, 0,     333 },
+    { 100, dk, true,  0,     100 },
+    { 17,  dk, false, 0,     17  },
+    { N,   dk, true,  N - 1, 1   },   // decode - 마지막 토큰 하나, 청크마다 Q 한 행만 읽음
+    { N,   dk, false, N - 1, 1   },
+    { 333, 48, true,  300,   40  },   // Br 정렬 아닌 시작, seq_len 넘는 q_len 은 잘림
+};
+
+static const int split_counts[] = { 1, 2, 4, 8, MAX_KV_SPLITS };
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+
+static out_t Output_single[N][dv];
+static float Output_single_scale[N];
+static out_t Output_split[N][dv];
+static float Output_split_scale[N];
+
+static calc_t Partial_O[MAX_KV_SPLITS][N][dv];
+static calc_t Partial_m[MAX_KV_SPLITS][N];
+static calc_t Partial_l[MAX_KV_SPLITS][N];
+
+// --------------------------------------------------------
+// split-KV 1회 - 청크 경계는 Bc 배수, 청크마다 thread
+// 반환: 청크 커널들의 DDR read 합 (combine 제외)
+// --------------------------------------------------------
+static unsigned long long run_split(int num_splits, int seq_len, int head_dim, bool causal,
+                                    int q_start, int q_len, int* used_splits, double* wall_ms) {
+    int kv_blocks = (seq_len + Bc - 1) / Bc;
+    int blocks_per_split = (kv_blocks + num_splits - 1) / num_splits;
+    int chunk = blocks_per_split * Bc;
+
+    vector<thread> workers;
+    vector<ddr_stats_t> chunk_stats(num_splits);
+    int s = 0;
+    auto t_start = chrono::steady_clock::now();
+    for (int kv_start = 0; kv_start < seq_len; kv_start += chunk, s++) {
+        int kv_end = (kv_start + chunk < seq_len) ? kv_start + chunk : seq_len;
+        workers.push_back(thread([=, &chunk_stats] {
+            ddr_stats = ddr_stats_t();
+            compute_attention_splitkv_HLS(Q_hls, K_hls, V_hls, Q_scale, K_scale, V_scale,
+                                          Partial_O[s], Partial_m[s], Partial_l[s],
+                                          seq_len, head_dim, causal, kv_start, kv_end, q_start, q_len);
+            chunk_stats[s] = ddr_stats;
+        }));
+    }
+    for (size_t w = 0; w < workers.size(); w++) {
+        workers[w].join();
+    }
+
+    combine_splitkv_HLS(Partial_O, Partial_m, Partial_l, Output_split,
+#if INT8_OUTPUT
+                        Output_split_scale,
+#endif
+                        s, seq_len, head_dim, q_start, q_len);
+    auto t_end = chrono::steady_clock::now();
+    *wall_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    *used_splits = s;
+
+    unsigned long long read_bytes = 0;
+    for (int c = 0; c < s; c++) {
+        read_bytes += chunk_stats[c].read_bytes;
+    }
+    return read_bytes;
+}
+
+// --------------------------------------------------------
+// 테스트 1회 - split 수 별로 단일 패스와 비교, 가장 나쁜 RMSE 반환
+// --------------------------------------------------------
+static double run_test(int seq_len, int head_dim, bool causal, int q_start, int q_len) {
+    int q_end = (q_start + q_len < seq_len) ? q_start + q_len : seq_len;
+    printf("==============================================\n");
+    printf("seq_len=%d, head_dim=%d, causal=%d, q rows [%d, %d)\n", seq_len, head_dim, (int)causal, q_start, q_end);
+    printf("==============================================\n");
+
+    srand(42);
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            Q_hls[i][k] = Q_ref[i][k];
+            K_hls[i][k] = K_ref[i][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+            V_hls[i][v] = V_ref[i][v];
+            Output_single[i][v] = 0;
+        }
+        Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        Output_single_scale[i] = 0.0f;
+    }
+
+    reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref,
+                             seq_len, head_dim, causal);
+
+    // 단일 패스 (DATAFLOW variant)
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_single, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_single_scale,
+#endif
+                          seq_len, head_dim, causal);
+    auto t_end = chrono::steady_clock::now();
+    double single_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    unsigned long long single_read = ddr_stats.read_bytes;
+    printf("single pass      : %8.3f ms, DDR read %llu bytes\n", single_ms, single_read);
+
+    double worst = 0.0;
+    const int num_counts = sizeof(split_counts) / sizeof(split_counts[0]);
+    for (int t = 0; t < num_counts; t++) {
+        for (int i = 0; i < N; i++) {
+            for (int v = 0; v < dv; v++) {
+                Output_split[i][v] = 0;
+            }
+            Output_split_scale[i] = 0.0f;
+        }
+
+        int used_splits;
+        double split_ms;
+        unsigned long long split_read = run_split(split_counts[t], seq_len, head_dim, causal,
+                                                  q_start, q_len, &used_splits, &split_ms);
+
+        int mismatches = 0, out_of_range_writes = 0;
+        double max_diff = 0.0, mse = 0.0;
+        for (int i = 0; i < N; i++) {
+            for (int d = 0; d < dv; d++) {
+                bool in_range = (i >= q_start && i < q_end && d < head_dim);
+                if (!in_range) {
+                    if (Output_split[i][d] != 0) out_of_range_writes++;
+                    continue;
+                }
+                float split_val = output_value(Output_split, Output_split_scale, i, d);
+                float single_val = output_value(Output_single, Output_single_scale, i, d);
+                if (Output_split[i][d] != Output_single[i][d]) mismatches++;
+                if (fabs(split_val - single_val) > max_diff) max_diff = fabs(split_val - single_val);
+                double error = split_val - Output_ref[i][d];
+                mse += error * error;
+            }
+        }
+        double rmse = sqrt(mse / ((q_end - q_start) * head_dim));
+
+        printf("splits=%2d (ran %2d): %8.3f ms, RMSE %.8f, vs single: %5d values differ, max diff %.8f, "
+               "chunk DDR read %llu bytes, oor %d\n",
+               split_counts[t], used_splits, split_ms, rmse, mismatches, max_diff, split_read, out_of_range_writes);
+
+        // 청크 1개는 단일 패스와 bit 단위로 같아야 함
+        if (used_splits == 1 && mismatches != 0) rmse = 1e9;
+        if (out_of_range_writes != 0) rmse = 1e9;
+        if (rmse > worst) worst = rmse;
+    }
+    printf("\n");
+    return worst;
+}
+
+// --------------------------------------------------------
+// 잘못된 num_splits - MAX_KV_SPLITS 초과는 MAX_KV_SPLITS 청크 combine 과 bit 단위로 같고,
+// 0 / 음수는 Output 을 쓰지 않아야 함 (partial 은 직전 run_test 입력의 seq_len = N, 청크 MAX_KV_SPLITS 개)
+// 반환: 다른 값 + 잘못 쓴 값 수
+// --------------------------------------------------------
+static int check_bad_num_splits() {
+    int used_splits;
+    double split_ms;
+    run_split(MAX_KV_SPLITS, N, dk, false, 0, N, &used_splits, &split_ms);
+    if (used_splits != MAX_KV_SPLITS) {
+        printf("bad num_splits: expected %d chunks, ran %d\n\n", MAX_KV_SPLITS, used_splits);
+        return 1;
+    }
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) Output_single[i][d] = Output_split[i][d];
+        Output_single_scale[i] = Output_split_scale[i];
+    }
+
+    int errors = 0;
+    static const int bad_splits[] = { MAX_KV_SPLITS + 5, 0, -3 };
+    for (int t = 0; t < 3; t++) {
+        for (int i = 0; i < N; i++) {
+            for (int d = 0; d < dv; d++) Output_split[i][d] = 7;
+            Output_split_scale[i] = 7.0f;
+        }
+        combine_splitkv_HLS(Partial_O, Partial_m, Partial_l, Output_split,
+#if INT8_OUTPUT
+                            Output_split_scale,
+#endif
+                            bad_splits[t], N, dk, 0, N);
+        for (int i = 0; i < N; i++) {
+            for (int d = 0; d < dv; d++) {
+                if (bad_splits[t] > 0 && Output_split[i][d] != Output_single[i][d]) errors++;
+                if (bad_splits[t] <= 0 && Output_split[i][d] != 7) errors++;
+            }
+        }
+    }
+    printf("bad num_splits (> MAX_KV_SPLITS / 0 / negative): %d errors\n\n", errors);
+    return errors;
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention split-KV testbench\n");
+    printf("N=%d, dk=%d, dv=%d, Bc=%d, MAX_KV_SPLITS=%d, KV_RESIDENT_MAX=%d\n",
+           N, dk, dv, Bc, MAX_KV_SPLITS, KV_RESIDENT_MAX);
+    printf("==============================================\n\n");
+
+    double worst_rmse = 0.0;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        const TestCase& tc = test_cases[t];
+        double rmse = run_test(tc.seq_len, tc.head_dim, tc.causal, tc.q_start, tc.q_len);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+    if (check_bad_num_splits() != 0) worst_rmse = 1e9;
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
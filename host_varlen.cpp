@@ -0,0 +1,270 @@
+// csim 소스: host_varlen.cpp host_common.cpp top_flash_attention_varlen.cpp top_flash_attention_DATAFLOW.cpp
+// ragged batch variant 를 시퀀스 길이가 제각각인 batch 로 돌려서 시퀀스별로 비교
+//   - 시퀀스마다 reference_attention_fp32 RMSE
+//   - 시퀀스마다 compute_attention_HLS (seq_len = 그 시퀀스 길이) 와 bit 단위로 같아야 함 (시퀀스 간 간섭 없음)
+//   - 마지막 시퀀스 뒤 토큰은 쓰지 않아야 함
+//   - 잘못된 cu_seqlens (감소 / 음수 / MAX_VARLEN_TOKENS 넘음) 는 skip 또는 잘림 - flat 버퍼 밖 접근 없음
+//   - 시간 / DDR 트래픽을 시퀀스마다 N 으로 padding 해서 compute_attention_HLS 호출하는 경우와 비교
+#include "host_common.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct TestCase {
+    int batch;
+    int seq_lens[MAX_BATCH];
+    int head_dim;
+    bool causal;
+};
+
+static const TestCase test_cases[] = {
+    { 6, { 17, 333, N, 100, 1, 64 },            dk, false },
+    { 6, { 17, 333, N, 100, 1, 64 },            dk, true  },
+    { 4, { 45, 7, 250, 31 },                    48, true  },
+    { 8, { N, N, N, N, N, N, N, N },            dk, false },
+    { 1, { 1 },                                 dk, true  },
+};
+
+static qint8_t Q_flat[MAX_VARLEN_TOKENS][dk];
+static qint8_t K_flat[MAX_VARLEN_TOKENS][dk];
+static qint8_t V_flat[MAX_VARLEN_TOKENS][dv];
+static float Q_scale_flat[MAX_VARLEN_TOKENS];
+static float K_scale_flat[MAX_VARLEN_TOKENS];
+static float V_scale_flat[MAX_VARLEN_TOKENS];
+static out_t Output_flat[MAX_VARLEN_TOKENS][dv];
+static float Output_scale_flat[MAX_VARLEN_TOKENS];
+static int cu_seqlens[MAX_BATCH + 1];
+
+// 시퀀스 하나 (reference / 단일 시퀀스 커널 입력)
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+static qint8_t Q_seq[N][dk];
+static qint8_t K_seq[N][dk];
+static qint8_t V_seq[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+static out_t Output_seq[N][dv];
+static float Output_seq_scale[N];
+
+// flat 버퍼의 시퀀스 b 를 [0, seq_len) 로 복사
+static void extract_seq(int b, int seq_len) {
+    int off = cu_seqlens[b];
+    for (int i = 0; i < N; i++) {
+        bool valid = (i < seq_len);
+        for (int k = 0; k < dk; k++) {
+            Q_seq[i][k] = valid ? Q_flat[off + i][k] : (qint8_t)0;
+            K_seq[i][k] = valid ? K_flat[off + i][k] : (qint8_t)0;
+            Q_ref[i][k] = Q_seq[i][k].to_int();
+            K_ref[i][k] = K_seq[i][k].to_int();
+        }
+        for (int v = 0; v < dv; v++) {
+            V_seq[i][v] = valid ? V_flat[off + i][v] : (qint8_t)0;
+            V_ref[i][v] = V_seq[i][v].to_int();
+            Output_seq[i][v] = 0;
+        }
+        Q_scale[i] = valid ? Q_scale_flat[off + i] : 0.0f;
+        K_scale[i] = valid ? K_scale_flat[off + i] : 0.0f;
+        V_scale[i] = valid ? V_scale_flat[off + i] : 0.0f;
+        Output_seq_scale[i] = 0.0f;
+    }
+}
+
+// --------------------------------------------------------
+// 테스트 1회 - batch 하나, 가장 나쁜 시퀀스 RMSE 반환 (불일치는 실패)
+// --------------------------------------------------------
+static double run_test(const TestCase& tc) {
+    printf("==============================================\n");
+    printf("batch=%d, head_dim=%d, causal=%d, seq_lens =", tc.batch, tc.head_dim, (int)tc.causal);
+    cu_seqlens[0] = 0;
+    for (int b = 0; b < tc.batch; b++) {
+        printf(" %d", tc.seq_lens[b]);
+        cu_seqlens[b + 1] = cu_seqlens[b] + tc.seq_lens[b];
+    }
+    int total_tokens = cu_seqlens[tc.batch];
+    printf(" (total %d tokens, padded %d)\n", total_tokens, tc.batch * N);
+    printf("==============================================\n");
+
+    srand(42);
+    for (int t = 0; t < MAX_VARLEN_TOKENS; t++) {
+        for (int k = 0; k < dk; k++) {
+            Q_flat[t][k] = (qint8_t)(rand() % 256 - 128);
+            K_flat[t][k] = (qint8_t)(rand() % 256 - 128);
+        }
+        for (int v = 0; v < dv; v++) {
+            V_flat[t][v] = (qint8_t)(rand() % 256 - 128);
+            Output_flat[t][v] = 0;
+        }
+        Q_scale_flat[t] = 0.02f + (rand() % 100) * 0.0005f;
+        K_scale_flat[t] = 0.02f + (rand() % 100) * 0.0005f;
+        V_scale_flat[t] = 0.02f + (rand() % 100) * 0.0005f;
+        Output_scale_flat[t] = 0.0f;
+    }
+
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    compute_attention_varlen_HLS(Q_flat, K_flat, V_flat, Output_flat, Q_scale_flat, K_scale_flat, V_scale_flat,
+#if INT8_OUTPUT
+                                 Output_scale_flat,
+#endif
+                                 cu_seqlens, tc.batch, tc.head_dim, tc.causal);
+    auto t_end = chrono::steady_clock::now();
+    double varlen_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    unsigned long long varlen_read = ddr_stats.read_bytes;
+
+    double worst = 0.0;
+    for (int b = 0; b < tc.batch; b++) {
+        int seq_len = tc.seq_lens[b];
+        int off = cu_seqlens[b];
+        extract_seq(b, seq_len);
+
+        reference_attention_fp32(Q_ref, K_ref, V_ref, Q_scale, K_scale, V_scale, Output_ref,
+                                 seq_len, tc.head_dim, tc.causal);
+        compute_attention_HLS(Q_seq, K_seq, V_seq, Output_seq, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                              Output_seq_scale,
+#endif
+                              seq_len, tc.head_dim, tc.causal);
+
+        int mismatches = 0;
+        double mse = 0.0;
+        for (int i = 0; i < seq_len; i++) {
+            for (int d = 0; d < tc.head_dim; d++) {
+                if (Output_flat[off + i][d] != Output_seq[i][d]) mismatches++;
+                double error = output_value(Output_flat, Output_scale_flat, off + i, d) - Output_ref[i][d];
+                mse += error * error;
+            }
+#if INT8_OUTPUT
+            if (Output_scale_flat[off + i] != Output_seq_scale[i]) mismatches++;
+#endif
+        }
+        double rmse = sqrt(mse / (seq_len * tc.head_dim));
+        printf("  seq %d (tokens [%4d, %4d)): RMSE %.8f, vs single-sequence kernel: %d values differ\n",
+               b, off, off + seq_len, rmse, mismatches);
+
+        if (mismatches != 0) rmse = 1e9;
+        if (rmse > worst) worst = rmse;
+    }
+
+    // 마지막 시퀀스 뒤 / head_dim 밖은 그대로 0
+    int out_of_range_writes = 0;
+    for (int t = 0; t < MAX_VARLEN_TOKENS; t++) {
+        for (int d = 0; d < dv; d++) {
+            if ((t >= total_tokens || d >= tc.head_dim) && Output_flat[t][d] != 0) out_of_range_writes++;
+        }
+        if (t >= total_tokens && Output_scale_flat[t] != 0.0f) out_of_range_writes++;
+    }
+    printf("  out-of-range writes: %d\n", out_of_range_writes);
+    if (out_of_range_writes != 0) worst = 1e9;
+
+    printf("  varlen: %8.3f ms, DDR read %llu bytes\n", varlen_ms, varlen_read);
+    return worst;
+}
+
+// --------------------------------------------------------
+// 기존 방식 (시퀀스마다 N 으로 padding 해서 compute_attention_HLS) 과 시간 / 트래픽 비교
+// --------------------------------------------------------
+static void report_padded(const TestCase& tc) {
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    for (int b = 0; b < tc.batch; b++) {
+        extract_seq(b, tc.seq_lens[b]);
+        compute_attention_HLS(Q_seq, K_seq, V_seq, Output_seq, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                              Output_seq_scale,
+#endif
+                              N, tc.head_dim, tc.causal);
+    }
+    auto t_end = chrono::steady_clock::now();
+    printf("  padded to N=%d: %8.3f ms, DDR read %llu bytes (%d calls)\n",
+           N, chrono::duration<double, milli>(t_end - t_start).count(), ddr_stats.read_bytes, tc.batch);
+}
+
+// --------------------------------------------------------
+// 잘못된 cu_seqlens - 끝이 MAX_VARLEN_TOKENS 를 넘는 시퀀스 (잘림), flat 버퍼 밖 / 음수 시작, 감소 (skip)
+// 유효한 두 시퀀스만 단일 시퀀스 커널과 bit 단위로 같고, 나머지 토큰은 쓰지 않아야 함
+// 반환: 다른 값 + 범위 밖 쓰기 수
+// --------------------------------------------------------
+static int check_bad_cu_seqlens() {
+    static const int bad_bounds[] = { MAX_VARLEN_TOKENS - 30, MAX_VARLEN_TOKENS + 500, 0, 100, 40, -20, 10 };
+    const int batch = sizeof(bad_bounds) / sizeof(bad_bounds[0]) - 1;
+    for (int b = 0; b <= batch; b++) cu_seqlens[b] = bad_bounds[b];
+    for (int t = 0; t < MAX_VARLEN_TOKENS; t++) {
+        for (int d = 0; d < dv; d++) Output_flat[t][d] = 7;
+        Output_scale_flat[t] = 7.0f;
+    }
+
+    compute_attention_varlen_HLS(Q_flat, K_flat, V_flat, Output_flat, Q_scale_flat, K_scale_flat, V_scale_flat,
+#if INT8_OUTPUT
+                                 Output_scale_flat,
+#endif
+                                 cu_seqlens, batch, dk, false);
+
+    // 유효한 시퀀스: b = 0 ([MAX_VARLEN_TOKENS - 30, MAX_VARLEN_TOKENS) 로 잘림), b = 2 ([0, 100))
+    static const int valid_seq[] = { 0, 2 };
+    static const int valid_len[] = { 30, 100 };
+    static bool written[MAX_VARLEN_TOKENS];
+    for (int t = 0; t < MAX_VARLEN_TOKENS; t++) written[t] = false;
+
+    int errors = 0;
+    for (int s = 0; s < 2; s++) {
+        int b = valid_seq[s], seq_len = valid_len[s], off = cu_seqlens[b];
+        extract_seq(b, seq_len);
+        compute_attention_HLS(Q_seq, K_seq, V_seq, Output_seq, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                              Output_seq_scale,
+#endif
+                              seq_len, dk, false);
+        for (int i = 0; i < seq_len; i++) {
+            written[off + i] = true;
+            for (int d = 0; d < dv; d++) {
+                if (Output_flat[off + i][d] != Output_seq[i][d]) errors++;
+            }
+        }
+    }
+    for (int t = 0; t < MAX_VARLEN_TOKENS; t++) {
+        if (written[t]) continue;
+        for (int d = 0; d < dv; d++) {
+            if (Output_flat[t][d] != 7) errors++;
+        }
+    }
+    printf("bad cu_seqlens (past MAX_VARLEN_TOKENS / negative / decreasing): %d errors\n\n", errors);
+    return errors;
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention ragged batch testbench\n");
+    printf("N=%d, dk=%d, dv=%d, MAX_BATCH=%d, MAX_VARLEN_TOKENS=%d, KV_RESIDENT_MAX=%d, INT8_OUTPUT=%d\n",
+           N, dk, dv, MAX_BATCH, MAX_VARLEN_TOKENS, KV_RESIDENT_MAX, INT8_OUTPUT);
+    printf("==============================================\n\n");
+
+    double worst_rmse = 0.0;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_test(test_cases[t]);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+        // padding 비교는 길이가 섞인 첫 batch 만
+        if (t == 0) report_padded(test_cases[t]);
+        printf("\n");
+    }
+    if (check_bad_cu_seqlens() != 0) worst_rmse = 1e9;
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+// csim 소스: host_window.cpp host_common.cpp top_flash_attention_window.cpp top_flash_attention_DATAFLOW.cpp
+// sliding-window variant 를 window 크기별로 돌려서 비교
+//   - window 를 적용한 fp32 reference RMSE (window > 0 이면 lookback (q - window, q])
+//   - window > 0 인데 causal = false 면 거부 - Output 을 쓰지 않아야 함
+//   - window <= 0 / causal 이고 window >= seq_len 이면 compute_attention_HLS 와 bit 단위로 같아야 함
+//   - 시간 / DDR 트래픽을 전체 범위 compute_attention_HLS 와 비교 (ring 이면 K/V 는 한 번만 읽음)
+//   - window 의 DDR 읽기가 전체 범위보다 많으면 실패
+//   - -DKV_RESIDENT_MAX=128 등으로 빌드하면 window 만 ring (N 보다 짧음) / 스트리밍 경로
+#include "host_common.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+struct TestCase {
+    int seq_len;
+    int head_dim;
+    bool causal;
+    int window;
+};
+
+static const TestCase test_cases[] = {
+    { N,   dk, true,  0    },   // window 없음 - compute_attention_HLS 와 같음
+    { N,   dk, true,  N    },   // 전체를 덮는 window - compute_attention_HLS 와 같음
+    { N,   dk, true,  400  },   // WINDOW_MAX 보다 큼 - 상주가 아니면 스트리밍 경로
+    { N,   dk, true,  256  },
+    { N,   dk, true,  128  },
+    { N,   dk, true,  64   },
+    { N,   dk, true,  1    },   // 자기 자신만
+    { N,   dk, false, 64   },   // non-causal window - 거부
+    { N,   dk, false, 256  },
+    { 333, 48, true,  100  },
+    { 17,  dk, true,  5    },
+    { 17,  dk, false, 5    },
+    { 200, dk, true,  0    },   // window 없음, 시퀀스 전체가 ring 에 들어감
+};
+
+static int8_t Q_ref[N][dk];
+static int8_t K_ref[N][dk];
+static int8_t V_ref[N][dv];
+static float Output_ref[N][dv];
+
+static qint8_t Q_hls[N][dk];
+static qint8_t K_hls[N][dk];
+static qint8_t V_hls[N][dv];
+static float Q_scale[N];
+static float K_scale[N];
+static float V_scale[N];
+
+static out_t Output_full[N][dv];
+static float Output_full_scale[N];
+static out_t Output_win[N][dv];
+static float Output_win_scale[N];
+
+// --------------------------------------------------------
+// window 를 적용한 FP32 reference (window <= 0 이면 전체, window > 0 이면 키 (i - window, i])
+// --------------------------------------------------------
+static void reference_attention_window(int seq_len, int head_dim, bool causal, int window) {
+    float scale = 1.0f / sqrtf((float)head_dim);
+    static float scores[N];
+    static bool key_on[N];
+
+    for (int i = 0; i < seq_len; i++) {
+        float max_val = -1e9;
+        for (int j = 0; j < seq_len; j++) {
+            key_on[j] = (window <= 0) ? !(causal && j > i) : (i - j < window && j <= i);
+            if (!key_on[j]) continue;
+            int sum = 0;
+            for (int k = 0; k < head_dim; k++) {
+                sum += (int)Q_ref[i][k] * (int)K_ref[j][k];
+            }
+            scores[j] = sum * Q_scale[i] * K_scale[j] * scale;
+            if (scores[j] > max_val) max_val = scores[j];
+        }
+
+        float sum_exp = 0.0f;
+        for (int j = 0; j < seq_len; j++) {
+            if (!key_on[j]) continue;
+            scores[j] = expf(scores[j] - max_val);
+            sum_exp += scores[j];
+        }
+
+        for (int d = 0; d < head_dim; d++) {
+            float sum_v = 0.0f;
+            for (int j = 0; j < seq_len; j++) {
+                if (key_on[j]) sum_v += scores[j] * V_ref[j][d] * V_scale[j];
+            }
+            Output_ref[i][d] = sum_v / sum_exp;
+        }
+    }
+}
+
+// --------------------------------------------------------
+// 테스트 1회 - RMSE 반환 (불일치 / 범위 밖 쓰기는 실패)
+// --------------------------------------------------------
+static double run_test(const TestCase& tc) {
+    srand(42);
+    for (int i = 0; i < N; i++) {
+        for (int k = 0; k < dk; k++) {
+            Q_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            K_ref[i][k] = (int8_t)(rand() % 256 - 128);
+            Q_hls[i][k] = Q_ref[i][k];
+            K_hls[i][k] = K_ref[i][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            V_ref[i][v] = (int8_t)(rand() % 256 - 128);
+            V_hls[i][v] = V_ref[i][v];
+            Output_full[i][v] = 0;
+            Output_win[i][v] = 0;
+        }
+        Q_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        K_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        V_scale[i] = 0.02f + (rand() % 100) * 0.0005f;
+        Output_full_scale[i] = 0.0f;
+        Output_win_scale[i] = 0.0f;
+    }
+
+    bool rejected = (tc.window > 0 && !tc.causal);
+    if (!rejected) reference_attention_window(tc.seq_len, tc.head_dim, tc.causal, tc.window);
+
+    // 기준: 전체 범위 (DATAFLOW variant)
+    ddr_stats = ddr_stats_t();
+    auto t_start = chrono::steady_clock::now();
+    compute_attention_HLS(Q_hls, K_hls, V_hls, Output_full, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                          Output_full_scale,
+#endif
+                          tc.seq_len, tc.head_dim, tc.causal);
+    auto t_end = chrono::steady_clock::now();
+    double full_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    unsigned long long full_read = ddr_stats.read_bytes;
+
+    ddr_stats = ddr_stats_t();
+    t_start = chrono::steady_clock::now();
+    compute_attention_window_HLS(Q_hls, K_hls, V_hls, Output_win, Q_scale, K_scale, V_scale,
+#if INT8_OUTPUT
+                                 Output_win_scale,
+#endif
+                                 tc.seq_len, tc.head_dim, tc.causal, tc.window);
+    t_end = chrono::steady_clock::now();
+    double win_ms = chrono::duration<double, milli>(t_end - t_start).count();
+    unsigned long long win_read = ddr_stats.read_bytes;
+
+    if (rejected) {
+        int writes = 0;
+        for (int i = 0; i < N; i++) {
+            for (int d = 0; d < dv; d++) {
+                if (Output_win[i][d] != 0) writes++;
+            }
+        }
+        printf("seq_len=%3d head_dim=%2d causal=%d window=%3d (rejected) | writes %d, DDR read %llu\n",
+               tc.seq_len, tc.head_dim, (int)tc.causal, tc.window, writes, win_read);
+        return (writes == 0 && win_read == 0) ? 0.0 : 1e9;
+    }
+
+    // window 가 전체를 덮으면 마스킹이 같음 -> bit 단위로 같아야 함 (window 는 causal 이라 causal 기준만)
+    bool covers_all = (tc.window <= 0 || (tc.causal && tc.window >= tc.seq_len));
+    int mismatches = 0, out_of_range_writes = 0;
+    double mse = 0.0;
+    for (int i = 0; i < N; i++) {
+        for (int d = 0; d < dv; d++) {
+            if (i >= tc.seq_len || d >= tc.head_dim) {
+                if (Output_win[i][d] != 0) out_of_range_writes++;
+                continue;
+            }
+            if (covers_all && Output_win[i][d] != Output_full[i][d]) mismatches++;
+            double error = output_value(Output_win, Output_win_scale, i, d) - Output_ref[i][d];
+            mse += error * error;
+        }
+    }
+    double rmse = sqrt(mse / (tc.seq_len * tc.head_dim));
+
+    bool use_ring = kv_window_use_ring(tc.seq_len, tc.window);
+    printf("seq_len=%3d head_dim=%2d causal=%d window=%3d (%s) | RMSE %.8f", tc.seq_len, tc.head_dim,
+           (int)tc.causal, tc.window, use_ring ? "ring  " : "stream", rmse);
+    if (covers_all) printf(", vs full: %d differ", mismatches);
+    printf(", oor %d\n", out_of_range_writes);
+    printf("    window %8.3f ms, DDR read %7llu | full %8.3f ms, DDR read %7llu | %.2fx time\n",
+           win_ms, win_read, full_ms, full_read, win_ms / full_ms);
+
+    return (mismatches == 0 && out_of_range_writes == 0 && win_read <= full_read) ? rmse : 1e9;
+}
+
+int main() {
+    printf("==============================================\n");
+    printf("Flash Attention sliding-window testbench\n");
+    printf("N=%d, Br=%d, Bc=%d, WINDOW_MAX=%d, KV_WINDOW_BLOCKS=%d, KV_RING_BLOCKS=%d, KV_RESIDENT_MAX=%d, "
+           "INT8_OUTPUT=%d\n", N, Br, Bc, WINDOW_MAX, KV_WINDOW_BLOCKS, KV_RING_BLOCKS, KV_RESIDENT_MAX, INT8_OUTPUT);
+    printf("==============================================\n");
+
+    double worst_rmse = 0.0;
+    const int num_cases = sizeof(test_cases) / sizeof(test_cases[0]);
+    for (int t = 0; t < num_cases; t++) {
+        double rmse = run_test(test_cases[t]);
+        if (rmse > worst_rmse) worst_rmse = rmse;
+    }
+
+    printf("==============================================\n");
+    printf("Worst RMSE: %.8f\n", worst_rmse);
+    if (worst_rmse < 0.1) {
+        printf("TEST PASSED (RMSE < 0.1)\n");
+    } else if (worst_rmse < 0.5) {
+        printf("TEST MARGINAL (0.1 <= RMSE < 0.5)\n");
+    } else {
+        printf("TEST FAILED (RMSE >= 0.5)\n");
+    }
+    printf("==============================================\n");
+
+    return (worst_rmse < 0.5) ? 0 : 1;
+}
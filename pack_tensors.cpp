@@ -0,0 +1,66 @@
+// raw .bin 덤프 -> tensor container (.tfc) 변환
+// 빌드: g++ -O2 pack_tensors.cpp tensor_file.cpp -o pack_tensors
+// 실행: ./pack_tensors [out.tfc] [seq_len] [head_dim]   (기본 attention_tensors.tfc 512 64)
+//   입력: Q/K/V_int8.bin, Q/K/V_scales.bin, Q/K/V_tensor.bin, Output_tensor.bin, Output_tensor_Q.bin
+//   *_tensor.bin 은 fixed_t (ap_fixed<16,5>) raw int16, Output_tensor_Q.bin 은 fp32
+#include "tensor_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define FIXED_T_FRAC_BITS 11    // ap_fixed<16,5>
+
+static std::vector<uint8_t> read_raw(const char* filename, size_t bytes) {
+    std::vector<uint8_t> buf(bytes);
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        exit(1);
+    }
+    size_t read = fread(buf.data(), 1, bytes, file);
+    if (read != bytes) {
+        fprintf(stderr, "Error reading file: %s (read %zu, expected %zu)\n", filename, read, bytes);
+        fclose(file);
+        exit(1);
+    }
+    fclose(file);
+    return buf;
+}
+
+int main(int argc, char** argv) {
+    const char* out = (argc > 1) ? argv[1] : "attention_tensors.tfc";
+    uint32_t rows = (argc > 2) ? (uint32_t)atoi(argv[2]) : 512;
+    uint32_t cols = (argc > 3) ? (uint32_t)atoi(argv[3]) : 64;
+    size_t elems = (size_t)rows * cols;
+
+    std::vector<uint8_t> q  = read_raw("Q_int8.bin", elems);
+    std::vector<uint8_t> k  = read_raw("K_int8.bin", elems);
+    std::vector<uint8_t> v  = read_raw("V_int8.bin", elems);
+    std::vector<uint8_t> qs = read_raw("Q_scales.bin", rows * sizeof(float));
+    std::vector<uint8_t> ks = read_raw("K_scales.bin", rows * sizeof(float));
+    std::vector<uint8_t> vs = read_raw("V_scales.bin", rows * sizeof(float));
+    std::vector<uint8_t> qf = read_raw("Q_tensor.bin", elems * sizeof(int16_t));
+    std::vector<uint8_t> kf = read_raw("K_tensor.bin", elems * sizeof(int16_t));
+    std::vector<uint8_t> vf = read_raw("V_tensor.bin", elems * sizeof(int16_t));
+    std::vector<uint8_t> of = read_raw("Output_tensor.bin", elems * sizeof(int16_t));
+    std::vector<uint8_t> oq = read_raw("Output_tensor_Q.bin", elems * sizeof(float));
+
+    const tfc_tensor_desc tensors[] = {
+        { "Q",          TFC_INT8,    TFC_QUANT_PER_ROW, 0, 2, { rows, cols }, q.data()  },
+        { "Q.scale",    TFC_FP32,    TFC_QUANT_NONE,    0, 1, { rows },       qs.data() },
+        { "K",          TFC_INT8,    TFC_QUANT_PER_ROW, 0, 2, { rows, cols }, k.data()  },
+        { "K.scale",    TFC_FP32,    TFC_QUANT_NONE,    0, 1, { rows },       ks.data() },
+        { "V",          TFC_INT8,    TFC_QUANT_PER_ROW, 0, 2, { rows, cols }, v.data()  },
+        { "V.scale",    TFC_FP32,    TFC_QUANT_NONE,    0, 1, { rows },       vs.data() },
+        { "Q_fixed",    TFC_FIXED16, TFC_QUANT_NONE, FIXED_T_FRAC_BITS, 2, { rows, cols }, qf.data() },
+        { "K_fixed",    TFC_FIXED16, TFC_QUANT_NONE, FIXED_T_FRAC_BITS, 2, { rows, cols }, kf.data() },
+        { "V_fixed",    TFC_FIXED16, TFC_QUANT_NONE, FIXED_T_FRAC_BITS, 2, { rows, cols }, vf.data() },
+        { "Output_fixed", TFC_FIXED16, TFC_QUANT_NONE, FIXED_T_FRAC_BITS, 2, { rows, cols }, of.data() },
+        { "Output_ref", TFC_FP32,    TFC_QUANT_NONE,    0, 2, { rows, cols }, oq.data() },
+    };
+    const int count = sizeof(tensors) / sizeof(tensors[0]);
+
+    tensor_file_write(out, tensors, count);
+    printf("Wrote %s (%d tensors, %ux%u)\n", out, count, rows, cols);
+    return 0;
+}
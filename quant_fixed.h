@@ -0,0 +1,71 @@
+#pragma once
+// --------------------------------------------------------
+// 활성값 per-row int8 양자화 (dcl_optimized.h 에서 include)
+// top_flash_attention_quant.cpp 의 LOAD_Q / LOAD_KV 에서 fixed_t 행을 읽으면서 바로 양자화
+// INT8_OUTPUT 이면 WRITE_OUTPUT 에서 정규화한 출력 행도 같은 규칙으로 양자화
+// --------------------------------------------------------
+// offline *_int8.bin / *_scales.bin 과 같은 규칙 (symmetric absmax)
+//   scale = absmax / 127,  q = round(x * 127 / absmax)  in [-127, 127]
+// 나눗셈은 행마다 한 번 (127 / absmax), 원소는 곱셈 + 반올림 / 포화
+// absmax == 0 인 행 (padding 등) 은 scale 0, q 0
+// --------------------------------------------------------
+// 행 원소 타입 T (ap_fixed<W, I>, 기본 fixed_t) 별 중간 타입 - 템플릿 kernel 의 FIXED_T 출력도 같은 규칙
+template <class T>
+struct quant_types {
+    typedef ap_ufixed<T::width, T::iwidth> abs_t;               // |x| (최소값의 절대값 포함)
+    typedef ap_fixed<T::width + 1, T::iwidth + 1> neg_t;        // -x (overflow 없음)
+    // 127 / absmax, absmax >= 2^-F 이면 < 2^(F+7) - 정수부 F+9, 소수부 12 bit
+    typedef ap_ufixed<(T::width - T::iwidth) + 21, (T::width - T::iwidth) + 9> inv_t;
+};
+typedef quant_types<fixed_t>::abs_t quant_abs_t;   // |fixed_t| = ap_ufixed<16,5> (-16 의 절대값 포함)
+typedef quant_types<fixed_t>::inv_t quant_inv_t;   // ap_ufixed<32,20>, absmax >= 2^-11 이면 < 2^18
+typedef ap_fixed<8,8,AP_RND_INF,AP_SAT_SYM> quant_round_t;   // [-127, 127]
+
+// q 를 채우고 absmax 를 반환 - scale 형식은 호출측 (입력: scale_fixed_t, 출력: float 포트)
+template <int COLS, class T>
+inline typename quant_types<T>::abs_t quant_row_absmax(const T x[COLS], int head_dim, qint8_t q[COLS]) {
+    #pragma HLS INLINE
+    typedef typename quant_types<T>::abs_t abs_t;
+    typedef typename quant_types<T>::neg_t neg_t;
+    typedef typename quant_types<T>::inv_t inv_t;
+    abs_t absmax = 0;
+    QUANT_ABSMAX:
+    for (int k = 0; k < COLS; k++) {
+        #pragma HLS UNROLL
+        abs_t a = (x[k] < 0) ? (abs_t)(-(neg_t)x[k]) : (abs_t)x[k];
+        if (k < head_dim && a > absmax) absmax = a;
+    }
+
+    if (absmax == 0) {
+        QUANT_ZERO:
+        for (int k = 0; k < COLS; k++) {
+            #pragma HLS UNROLL
+            q[k] = 0;
+        }
+        return absmax;
+    }
+
+    inv_t inv = (inv_t)127 / absmax;
+    QUANT_ELEM:
+    for (int k = 0; k < COLS; k++) {
+        #pragma HLS UNROLL
+        quant_round_t r = x[k] * inv;
+        q[k] = (k < head_dim) ? (qint8_t)r.to_int() : (qint8_t)0;
+    }
+    return absmax;
+}
+
+template <int COLS, class T>
+inline scale_fixed_t quant_row(const T x[COLS], int head_dim, qint8_t q[COLS]) {
+    #pragma HLS INLINE
+    typename quant_types<T>::abs_t absmax = quant_row_absmax<COLS>(x, head_dim, q);
+    const ap_ufixed<24,0> INV_127 = 1.0 / 127.0;
+    return (scale_fixed_t)(absmax * INV_127);
+}
+
+// 출력 scale (Output_scale 포트, float) - 행당 곱셈 1번
+template <class A>
+inline float quant_out_scale(A absmax) {
+    #pragma HLS INLINE
+    return absmax.to_float() * (1.0f / 127.0f);
+}
@@ -0,0 +1,199 @@
+#pragma once
+// --------------------------------------------------------
+// Online softmax 용 fixed-point exp / reciprocal (dcl_optimized.h 에서 include)
+// PROCESS_ROW 의 hls::exp((float)...) 와 WRITE_OUTPUT 의 1 / local_l 대체
+// --------------------------------------------------------
+// USE_FIXED_EXP   : 1 = LUT + 선형 보간 (기본), 0 = 기존 float hls::exp / fixed 나눗셈
+// EXP_LUT_BITS    : 2^f 테이블 index bit 수 (entry 2^bits + 1), 클수록 정확 / ROM 증가
+// RECIP_LUT_BITS  : 1/m 테이블 index bit 수
+// 기본값 (exp 6, recip 8) 에서 최대 오차 ~1 LSB (2^-16), 4 bit 면 exp ~14 / recip ~57 LSB
+// float 경로 대비 fp32 변환 + hls::exp 파이프라인 / 나눗셈기가 빠지고 ROM 1개 + 곱셈 1개로 줄어듦
+// INT8_PV         : 1 = P·V 를 uint8 x int8 -> int32 로 (P * scale_V 를 row 별 shift 로 양자화)
+//                   0 = 기존 ap_fixed<32,16> x int8 (기본)
+// --------------------------------------------------------
+#ifndef USE_FIXED_EXP
+#define USE_FIXED_EXP   1
+#endif
+#ifndef EXP_LUT_BITS
+#define EXP_LUT_BITS    6
+#endif
+#ifndef INT8_PV
+#define INT8_PV         0
+#endif
+#ifndef RECIP_LUT_BITS
+#define RECIP_LUT_BITS  8
+#endif
+
+#define EXP_LUT_SIZE    (1 << EXP_LUT_BITS)
+#define RECIP_LUT_SIZE  (1 << RECIP_LUT_BITS)
+#define LUT_FRAC_BITS   24      // 테이블 raw 값의 소수부 bit 수 (Q1.24)
+
+// --------------------------------------------------------
+// 컴파일 타임 테이블 생성 (constexpr, 합성 시 ROM)
+// --------------------------------------------------------
+// 2^f, f in [0, 1] - 테일러 급수 (f*ln2 <= 0.7 이라 20 항이면 double 정밀도)
+constexpr double lut_exp2(double f) {
+    double x = f * 0.69314718055994530942;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 20; k++) {
+        term = term * x / k;
+        sum += term;
+    }
+    return sum;
+}
+
+struct exp2_lut_t  { unsigned int v[EXP_LUT_SIZE + 1]; };
+struct recip_lut_t { unsigned int v[RECIP_LUT_SIZE + 1]; };
+
+// EXP2_LUT.v[i] = 2^(i / EXP_LUT_SIZE), Q1.24
+constexpr exp2_lut_t make_exp2_lut() {
+    exp2_lut_t t = {};
+    for (int i = 0; i <= EXP_LUT_SIZE; i++) {
+        t.v[i] = (unsigned int)(lut_exp2((double)i / EXP_LUT_SIZE) * (1 << LUT_FRAC_BITS) + 0.5);
+    }
+    return t;
+}
+
+// RECIP_LUT.v[i] = 1 / (1 + i / RECIP_LUT_SIZE), Q1.24
+constexpr recip_lut_t make_recip_lut() {
+    recip_lut_t t = {};
+    for (int i = 0; i <= RECIP_LUT_SIZE; i++) {
+        t.v[i] = (unsigned int)((double)(1 << LUT_FRAC_BITS) * RECIP_LUT_SIZE / (RECIP_LUT_SIZE + i) + 0.5);
+    }
+    return t;
+}
+
+constexpr exp2_lut_t  EXP2_LUT  = make_exp2_lut();
+constexpr recip_lut_t RECIP_LUT = make_recip_lut();
+
+// --------------------------------------------------------
+// 계산 타입 T (ap_fixed<W, I>) 템플릿 - 기본 calc_t (ap_fixed<32,16>)
+// 인자는 T 로 변환해서 받음 (식 타입에서 T 를 추론하지 않음): attn_exp(x) = attn_exp<calc_t>(x)
+// 템플릿 kernel (flash_attention_tmpl.h) 은 attn_exp<CFG::calc_type> 처럼 명시
+// --------------------------------------------------------
+template <class T>
+struct attn_arg { typedef T type; };
+
+// --------------------------------------------------------
+// exp(x), x <= 0 (score - m_new, m_prev - m_new 는 항상 <= 0)
+// exp(x) = 2^y, y = x * log2(e) = -n + f (n 정수, f in [0, 1))
+//   2^f  : 테이블 상위 EXP_LUT_BITS bit + 나머지 bit 로 선형 보간
+//   2^-n : shift
+// --------------------------------------------------------
+template <class T = calc_t>
+inline T attn_exp(typename attn_arg<T>::type x) {
+    #pragma HLS INLINE
+#if USE_FIXED_EXP
+    const int W = T::width;
+    const int F = T::width - T::iwidth;                 // 소수부 bit
+    static_assert(F + 2 > EXP_LUT_BITS, "attn_exp: calc type needs more fraction bits than EXP_LUT_BITS");
+    const ap_ufixed<18,1> LOG2E = 1.44269504088896;
+
+    ap_fixed<W + 4, T::iwidth + 2> y = x * LOG2E;
+    if (y >= 0) return T(1.0);                          // x == 0 (반올림 오차 방어)
+
+    ap_int<T::iwidth + 2> y_int = y.range(W + 3, F + 2);    // floor(y) (2의 보수)
+    ap_uint<F + 2> y_frac = y.range(F + 1, 0);              // y - floor(y), 1/2^(F+2) 단위
+    int n = -(int)y_int;
+    if (n >= F + 1) return T(0);                        // 2^-(F+1) 미만은 출력 LSB 아래
+
+    ap_uint<EXP_LUT_BITS> idx = y_frac >> (F + 2 - EXP_LUT_BITS);
+    ap_uint<F + 2 - EXP_LUT_BITS> t = y_frac;           // 보간 위치 (하위 bit)
+    ap_uint<26> lo = EXP2_LUT.v[idx];
+    ap_uint<26> hi = EXP2_LUT.v[idx + 1];
+    ap_uint<26> interp = lo + (((hi - lo) * t) >> (F + 2 - EXP_LUT_BITS));
+
+    // Q1.24 -> T (소수부 F bit) 로 옮기면서 2^-n 적용
+    int shift = LUT_FRAC_BITS - F + n;
+    ap_uint<W> raw = (shift >= 0) ? (ap_uint<W>)(interp >> shift) : ((ap_uint<W>)interp << -shift);
+    T result;
+    result.range(W - 1, 0) = raw;
+    return result;
+#else
+    return (T)hls::exp((float)x);
+#endif
+}
+
+// --------------------------------------------------------
+// 1 / x, x > 0 (local_l >= 1 - 최대 score 위치의 exp(0) 포함)
+// x = m * 2^e (m in [1, 2)) 로 정규화, 1/m 은 테이블 보간, 2^-e 는 shift
+// --------------------------------------------------------
+template <class T = calc_t>
+inline T attn_recip(typename attn_arg<T>::type x) {
+    #pragma HLS INLINE
+#if USE_FIXED_EXP
+    const int W = T::width;
+    const int F = T::width - T::iwidth;
+    ap_uint<W - 1> raw = x.range(W - 2, 0);
+    if (raw == 0) return T(0);
+
+    // leading one 위치 (x = raw / 2^F)
+    int msb = 0;
+    FIND_MSB:
+    for (int b = 0; b < W - 1; b++) {
+        #pragma HLS UNROLL
+        if (raw[b]) msb = b;
+    }
+
+    // m 의 소수부를 30 bit 로 정렬 (msb 아래 bit)
+    ap_uint<W + 30> wide = raw;
+    ap_uint<30> m_frac = (ap_uint<30>)(((msb <= 30) ? (ap_uint<W + 30>)(wide << (30 - msb))
+                                                    : (ap_uint<W + 30>)(wide >> (msb - 30))) & 0x3FFFFFFF);
+    ap_uint<RECIP_LUT_BITS> idx = m_frac >> (30 - RECIP_LUT_BITS);
+    ap_uint<30 - RECIP_LUT_BITS> t = m_frac;
+    ap_uint<26> lo = RECIP_LUT.v[idx];
+    ap_uint<26> hi = RECIP_LUT.v[idx + 1];
+    ap_uint<26> interp = lo - (((lo - hi) * (ap_uint<56>)t) >> (30 - RECIP_LUT_BITS));
+
+    // 1/x = (1/m) * 2^-(msb - F), Q1.24 -> T
+    int shift = LUT_FRAC_BITS - F + (msb - F);
+    ap_uint<W> out_raw = (shift >= 0) ? (ap_uint<W>)(interp >> shift) : ((ap_uint<W>)interp << -shift);
+    T result;
+    result.range(W - 1, 0) = out_raw;
+    return result;
+#else
+    return (T)(T(1.0) / x);
+#endif
+}
+
+// --------------------------------------------------------
+// P 양자화 (INT8_PV)
+// scaled_P = P * scale_V (>= 0) 를 row 안 최대값 기준 2^shift step 으로 uint8 양자화
+//   q = round(raw >> shift), 최대값은 [128, 255] -> 유효 7~8 bit
+//   step 이 2 의 거듭제곱이라 양자화 / 역양자화 모두 shift (곱셈기, 나눗셈기 없음)
+// shift 는 T 의 raw (LSB) 단위
+// --------------------------------------------------------
+template <class T = calc_t>
+inline int pv_quant_shift(typename attn_arg<T>::type p_max) {
+    #pragma HLS INLINE
+    ap_uint<T::width - 1> raw = p_max.range(T::width - 2, 0);
+    int msb = 0;
+    PV_FIND_MSB:
+    for (int b = 0; b < T::width - 1; b++) {
+        #pragma HLS UNROLL
+        if (raw[b]) msb = b;
+    }
+    return msb - 7;     // (p_max raw) >> shift 가 [128, 255]
+}
+
+template <class T = calc_t>
+inline ap_uint<8> pv_quant(typename attn_arg<T>::type x, int shift) {
+    #pragma HLS INLINE
+    ap_uint<T::width - 1> raw = x.range(T::width - 2, 0);
+    if (shift <= 0) return (ap_uint<8>)(raw << -shift);
+    ap_uint<T::width> rounded = ((ap_uint<T::width>)raw + ((ap_uint<T::width>)1 << (shift - 1))) >> shift;
+    return (rounded > 255) ? (ap_uint<8>)255 : (ap_uint<8>)rounded;
+}
+
+// sum(q * V) * 2^shift (raw 단위) -> T
+template <class T = calc_t>
+inline T pv_dequant(qint32_t acc, int shift) {
+    #pragma HLS INLINE
+    ap_int<T::width + 32> wide = acc;
+    ap_int<T::width + 32> raw = (shift >= 0) ? (ap_int<T::width + 32>)(wide << shift)
+                                             : (ap_int<T::width + 32>)(wide >> -shift);
+    T result;
+    result.range(T::width - 1, 0) = raw.range(T::width - 1, 0);
+    return result;
+}
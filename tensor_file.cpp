@@ -0,0 +1,246 @@
+#include "tensor_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t dtype_bytes(int dtype) {
+    switch (dtype) {
+    case TFC_INT8:    return 1;
+    case TFC_FIXED16: return 2;
+    case TFC_FP32:    return 4;
+    default:          return 0;
+    }
+}
+
+static const char* dtype_name(int dtype) {
+    switch (dtype) {
+    case TFC_INT8:    return "int8";
+    case TFC_FIXED16: return "fixed16";
+    case TFC_FP32:    return "fp32";
+    default:          return "unknown";
+    }
+}
+
+static uint64_t align_up(uint64_t x) {
+    return (x + TFC_ALIGN - 1) / TFC_ALIGN * TFC_ALIGN;
+}
+
+// shape 곱 - uint64 overflow 면 false
+static bool element_count(const uint32_t* shape, int ndim, uint64_t* count) {
+    uint64_t n = 1;
+    for (int d = 0; d < ndim; d++) {
+        if (shape[d] != 0 && n > UINT64_MAX / shape[d]) return false;
+        n *= shape[d];
+    }
+    *count = n;
+    return true;
+}
+
+// element 수 * dtype 크기 - overflow 면 false
+static bool tensor_bytes(const uint32_t* shape, int ndim, size_t elem, uint64_t* bytes) {
+    uint64_t count;
+    if (!element_count(shape, ndim, &count) || (elem != 0 && count > UINT64_MAX / elem)) return false;
+    *bytes = count * elem;
+    return true;
+}
+
+// --------------------------------------------------------
+// 열기 - mmap 후 header / entry table 검증
+// 데이터는 읽지 않음 (페이지는 실제로 접근할 때 로드)
+// --------------------------------------------------------
+void tensor_file_open(tensor_file* tf, const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        exit(1);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(tfc_header)) {
+        fprintf(stderr, "Error reading file: %s (not a tensor container)\n", filename);
+        close(fd);
+        exit(1);
+    }
+
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Error mapping file: %s\n", filename);
+        close(fd);
+        exit(1);
+    }
+
+    tf->fd = fd;
+    tf->base = (const uint8_t*)base;
+    tf->size = st.st_size;
+    tf->header = (const tfc_header*)base;
+    tf->entries = (const tfc_entry*)(tf->base + sizeof(tfc_header));
+
+    const tfc_header* h = tf->header;
+    bool ok = memcmp(h->magic, TFC_MAGIC, 4) == 0
+           && h->version == TFC_VERSION
+           && h->entry_bytes == sizeof(tfc_entry)
+           && h->file_bytes == tf->size
+           && sizeof(tfc_header) + (uint64_t)h->num_tensors * sizeof(tfc_entry) <= tf->size;
+    if (!ok) {
+        fprintf(stderr, "Error reading file: %s (bad tensor container header)\n", filename);
+        tensor_file_close(tf);
+        exit(1);
+    }
+
+    // 데이터는 header / entry table 뒤에만 (offset + nbytes 는 overflow 나지 않게 뺄셈으로 비교)
+    uint64_t data_start = sizeof(tfc_header) + (uint64_t)h->num_tensors * sizeof(tfc_entry);
+    for (uint32_t t = 0; t < h->num_tensors; t++) {
+        const tfc_entry& e = tf->entries[t];
+        size_t elem = dtype_bytes(e.dtype);
+        uint64_t nbytes = 0;
+        bool valid = elem != 0
+                  && memchr(e.name, '\0', TFC_NAME_LEN) != NULL
+                  && e.ndim >= 1 && e.ndim <= TFC_MAX_DIMS
+                  && e.offset % TFC_ALIGN == 0
+                  && tensor_bytes(e.shape, e.ndim, elem, &nbytes)
+                  && e.nbytes == nbytes
+                  && e.offset >= data_start
+                  && e.offset <= tf->size
+                  && e.nbytes <= tf->size - e.offset;
+        if (!valid) {
+            fprintf(stderr, "Error reading file: %s (bad entry %u)\n", filename, t);
+            tensor_file_close(tf);
+            exit(1);
+        }
+    }
+}
+
+void tensor_file_close(tensor_file* tf) {
+    if (tf->base) munmap((void*)tf->base, tf->size);
+    if (tf->fd >= 0) close(tf->fd);
+    tf->fd = -1;
+    tf->base = NULL;
+    tf->size = 0;
+    tf->header = NULL;
+    tf->entries = NULL;
+}
+
+const tfc_entry* tensor_file_find(const tensor_file* tf, const char* name) {
+    for (uint32_t t = 0; t < tf->header->num_tensors; t++) {
+        if (strncmp(tf->entries[t].name, name, TFC_NAME_LEN) == 0) {
+            return &tf->entries[t];
+        }
+    }
+    return NULL;
+}
+
+// 이름 / dtype / (rows, cols) 확인 - 불일치면 exit
+static const tfc_entry* require_tensor(const tensor_file* tf, const char* name, int dtype,
+                                       uint64_t rows, uint64_t cols) {
+    const tfc_entry* e = tensor_file_find(tf, name);
+    if (e == NULL) {
+        fprintf(stderr, "Tensor not found in container: %s\n", name);
+        exit(1);
+    }
+    if (e->dtype != dtype) {
+        fprintf(stderr, "Tensor %s: dtype %s, expected %s\n",
+                name, dtype_name(e->dtype), dtype_name(dtype));
+        exit(1);
+    }
+    uint64_t e_cols = e->shape[e->ndim - 1];
+    uint64_t e_count = 0;
+    element_count(e->shape, e->ndim, &e_count);     // open 에서 검증됨
+    uint64_t e_rows = e_count / (e_cols ? e_cols : 1);
+    if (e->ndim == 1) {
+        e_rows = e_cols;
+        e_cols = 1;
+    }
+    if (e_rows != rows || e_cols != cols) {
+        fprintf(stderr, "Tensor %s: shape %llux%llu, expected %llux%llu\n", name,
+                (unsigned long long)e_rows, (unsigned long long)e_cols,
+                (unsigned long long)rows, (unsigned long long)cols);
+        exit(1);
+    }
+    return e;
+}
+
+const int8_t* tensor_file_int8(const tensor_file* tf, const char* name, int rows, int cols) {
+    const tfc_entry* e = require_tensor(tf, name, TFC_INT8, rows, cols);
+    return (const int8_t*)(tf->base + e->offset);
+}
+
+const int16_t* tensor_file_fixed16(const tensor_file* tf, const char* name, int rows, int cols, int frac_bits) {
+    const tfc_entry* e = require_tensor(tf, name, TFC_FIXED16, rows, cols);
+    if (e->frac_bits != frac_bits) {
+        fprintf(stderr, "Tensor %s: frac_bits %d, expected %d\n", name, e->frac_bits, frac_bits);
+        exit(1);
+    }
+    return (const int16_t*)(tf->base + e->offset);
+}
+
+const float* tensor_file_fp32(const tensor_file* tf, const char* name, int count) {
+    const tfc_entry* e = require_tensor(tf, name, TFC_FP32, count, 1);
+    return (const float*)(tf->base + e->offset);
+}
+
+// --------------------------------------------------------
+// 쓰기 - header, entry table, 64 byte 정렬 데이터
+// --------------------------------------------------------
+void tensor_file_write(const char* filename, const tfc_tensor_desc* tensors, int count) {
+    tfc_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TFC_MAGIC, 4);
+    header.version = TFC_VERSION;
+    header.num_tensors = count;
+    header.entry_bytes = sizeof(tfc_entry);
+
+    tfc_entry* entries = (tfc_entry*)calloc(count, sizeof(tfc_entry));
+    uint64_t offset = align_up(sizeof(tfc_header) + (uint64_t)count * sizeof(tfc_entry));
+    for (int t = 0; t < count; t++) {
+        const tfc_tensor_desc& d = tensors[t];
+        uint64_t nbytes = 0;
+        if (strlen(d.name) >= TFC_NAME_LEN || d.ndim < 1 || d.ndim > TFC_MAX_DIMS
+            || dtype_bytes(d.dtype) == 0 || !tensor_bytes(d.shape, d.ndim, dtype_bytes(d.dtype), &nbytes)) {
+            fprintf(stderr, "Invalid tensor description: %s\n", d.name);
+            exit(1);
+        }
+        tfc_entry& e = entries[t];
+        strncpy(e.name, d.name, TFC_NAME_LEN - 1);
+        e.dtype = (uint8_t)d.dtype;
+        e.quant = (uint8_t)d.quant;
+        e.ndim = (uint8_t)d.ndim;
+        e.frac_bits = (int8_t)d.frac_bits;
+        for (int k = 0; k < d.ndim; k++) {
+            e.shape[k] = d.shape[k];
+        }
+        e.offset = offset;
+        e.nbytes = nbytes;
+        offset = align_up(offset + e.nbytes);
+    }
+    header.file_bytes = offset;
+
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        exit(1);
+    }
+
+    static const uint8_t zeros[TFC_ALIGN] = { 0 };
+    uint64_t pos = 0;
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(entries, sizeof(tfc_entry), count, file);
+    pos = sizeof(header) + (uint64_t)count * sizeof(tfc_entry);
+    for (int t = 0; t < count; t++) {
+        fwrite(zeros, 1, entries[t].offset - pos, file);
+        fwrite(tensors[t].data, 1, entries[t].nbytes, file);
+        pos = entries[t].offset + entries[t].nbytes;
+    }
+    fwrite(zeros, 1, header.file_bytes - pos, file);
+
+    if (ferror(file)) {
+        fprintf(stderr, "Error writing file: %s\n", filename);
+        fclose(file);
+        exit(1);
+    }
+    fclose(file);
+    free(entries);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// --------------------------------------------------------
+// Tensor container (.tfc) - 파일 하나에 여러 텐서 + shape / dtype / 양자화 정보
+// --------------------------------------------------------
+// 레이아웃 (little-endian)
+//   [0, 64)                  tfc_header
+//   [64, 64 + 64 * count)    tfc_entry table
+//   data section             텐서마다 TFC_ALIGN(64) byte 정렬, row-major
+//
+// 읽기는 mmap - 데이터 포인터를 그대로 넘김 (fread / 복사 없음, 파일 크기와 무관하게 O(1) open)
+// 이름 규칙: int8 텐서 "Q" 의 scale 은 "Q.scale"
+//   TFC_QUANT_PER_ROW    : scale shape = 마지막 dim 을 뺀 shape (행마다 하나)
+//   TFC_QUANT_PER_TENSOR : scale shape = [1]
+
+#define TFC_MAGIC        "FATC"
+#define TFC_VERSION      1
+#define TFC_ALIGN        64
+#define TFC_MAX_DIMS     4
+#define TFC_NAME_LEN     24
+
+enum tfc_dtype {
+    TFC_INT8    = 1,
+    TFC_FP32    = 2,
+    TFC_FIXED16 = 3,    // int16 raw, 값 = raw / 2^frac_bits (fixed_t = frac_bits 11)
+};
+
+enum tfc_quant {
+    TFC_QUANT_NONE       = 0,
+    TFC_QUANT_PER_TENSOR = 1,
+    TFC_QUANT_PER_ROW    = 2,
+};
+
+struct tfc_header {
+    char     magic[4];
+    uint32_t version;
+    uint32_t num_tensors;
+    uint32_t entry_bytes;       // sizeof(tfc_entry)
+    uint64_t file_bytes;
+    uint8_t  reserved[40];
+};
+
+struct tfc_entry {
+    char     name[TFC_NAME_LEN];    // '\0' 로 끝남
+    uint8_t  dtype;                 // tfc_dtype
+    uint8_t  quant;                 // tfc_quant (int8 텐서만)
+    uint8_t  ndim;
+    int8_t   frac_bits;             // TFC_FIXED16 만
+    uint32_t shape[TFC_MAX_DIMS];
+    uint32_t reserved;
+    uint64_t offset;                // 파일 시작 기준, TFC_ALIGN 배수
+    uint64_t nbytes;
+};
+
+static_assert(sizeof(tfc_header) == 64, "tfc_header must be 64 bytes");
+static_assert(sizeof(tfc_entry) == 64, "tfc_entry must be 64 bytes");
+
+// mmap 된 container (tensor_file.cpp)
+struct tensor_file {
+    int fd;
+    const uint8_t* base;
+    size_t size;
+    const tfc_header* header;
+    const tfc_entry* entries;
+};
+
+// 열기 + header / entry 검증 (실패 시 exit)
+void tensor_file_open(tensor_file* tf, const char* filename);
+void tensor_file_close(tensor_file* tf);
+
+// 이름으로 찾기 (없으면 NULL)
+const tfc_entry* tensor_file_find(const tensor_file* tf, const char* name);
+
+// dtype / shape 확인 후 mmap 데이터 포인터 (불일치 시 exit)
+// rows 는 마지막 dim 을 뺀 dim 들의 곱 - [B, H, S, D] 도 rows = B*H*S, cols = D 로 읽음
+const int8_t*  tensor_file_int8(const tensor_file* tf, const char* name, int rows, int cols);
+const int16_t* tensor_file_fixed16(const tensor_file* tf, const char* name, int rows, int cols, int frac_bits);
+const float*   tensor_file_fp32(const tensor_file* tf, const char* name, int count);
+
+// 쓰기 - pack_tensors.cpp 등 변환 도구용
+struct tfc_tensor_desc {
+    const char* name;
+    tfc_dtype dtype;
+    tfc_quant quant;
+    int frac_bits;
+    int ndim;
+    uint32_t shape[TFC_MAX_DIMS];
+    const void* data;
+};
+void tensor_file_write(const char* filename, const tfc_tensor_desc* tensors, int count);
@@ -0,0 +1,196 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// Incremental decode variant (autoregressive, 새 토큰 1 개 / step)
+// --------------------------------------------------------
+// 1. 새 토큰의 k / v (+ scale) 를 KV cache 행 pos 에 append (DDR write 1 행)
+// 2. q 1 행으로 prefix [0, pos] 전체를 Bc 블록 단위 스트리밍 (load_kv_task_decode | process_task_tmpl DATAFLOW)
+//    새 행 pos 는 방금 쓴 DDR 대신 온칩 k / v 를 그대로 사용 (m_axi read-after-write 없음)
+// Q 타일 (Br 행) / 전체 N 행 재계산이 없어서 step 당 트래픽 = prefix K/V 1 회
+// process / compute stage 는 flash_attention_tmpl.h 의 BR = 1 config (attn_cfg_decode), 이 파일은 로더와 kv_source_decode
+// 연산 순서는 DATAFLOW variant 의 causal 행 pos 와 같음 -> 출력 bit 단위로 동일
+
+// 새 토큰 행 (온칩) - load_kv_task_decode 가 pos 행 대신 사용
+struct decode_new_kv_t {
+    qint8_t k[dk];
+    qint8_t v[dv];
+    scale_fixed_t scale_k;
+    scale_fixed_t scale_v;
+};
+
+// Load KV 함수 - 블록 [j, j+Bc) 를 PIPO 버퍼로 (prefix 밖 행, head_dim 밖 열은 0)
+void load_kv_task_decode(
+    qint8_t K_cache[N][dk],
+    qint8_t V_cache[N][dv],
+    float scale_K_cache[N],
+    float scale_V_cache[N],
+    const decode_new_kv_t& new_kv,
+    int j,
+    int pos,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        bool row_valid = (kv_row <= pos);
+        bool row_new = (kv_row == pos);
+        kv_scale_K[c] = !row_valid ? (scale_fixed_t)0 : row_new ? new_kv.scale_k : (scale_fixed_t)scale_K_cache[kv_row];
+        kv_scale_V[c] = !row_valid ? (scale_fixed_t)0 : row_new ? new_kv.scale_v : (scale_fixed_t)scale_V_cache[kv_row];
+        for (int k = 0; k < dk; k++) {
+            kv_K[c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : row_new ? new_kv.k[k] : K_cache[kv_row][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            kv_V[c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : row_new ? new_kv.v[v] : V_cache[kv_row][v];
+        }
+        if (row_valid && !row_new) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// KV source - Q 타일은 행 pos 하나, prefix [0, pos] 블록 전부 (마스크는 kv_end = pos + 1 만, 새 행이 마지막이라 causal 대각과 같음)
+struct kv_source_decode {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*K_cache)[dk];
+    qint8_t (*V_cache)[dv];
+    float* scale_K_cache;
+    float* scale_V_cache;
+    const decode_new_kv_t* new_kv;
+    int pos;
+    int head_dim;
+
+    int first_block(int) const { return 0; }
+    int end_block(int) const { return (pos + 1 + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int, int) const { return attn_causal_mask(pos + 1, false); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_decode(K_cache, V_cache, scale_K_cache, scale_V_cache, *new_kv,
+                            j, pos, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+
+void compute_attention_decode_HLS(
+    qint8_t q_new[dk],
+    qint8_t k_new[dk],
+    qint8_t v_new[dv],
+    float scale_q,
+    float scale_k,
+    float scale_v,
+    qint8_t K_cache[N][dk],
+    qint8_t V_cache[N][dv],
+    float scale_K_cache[N],
+    float scale_V_cache[N],
+    out_t Output[dv],
+#if INT8_OUTPUT
+    float Output_scale[1],
+#endif
+    int pos,
+    int head_dim
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=q_new bundle=gmem0 depth=dk
+    #pragma HLS INTERFACE mode=m_axi port=k_new bundle=gmem0 depth=dk
+    #pragma HLS INTERFACE mode=m_axi port=v_new bundle=gmem0 depth=dv
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K_cache       bundle=gmem1 depth=N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_K_cache bundle=gmem1 depth=N
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V_cache       bundle=gmem2 depth=N*dv
+    #pragma HLS INTERFACE mode=m_axi port=scale_V_cache bundle=gmem2 depth=N
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=1
+#endif
+
+    #pragma HLS INTERFACE mode=s_axilite port=scale_q
+    #pragma HLS INTERFACE mode=s_axilite port=scale_k
+    #pragma HLS INTERFACE mode=s_axilite port=scale_v
+    #pragma HLS INTERFACE mode=s_axilite port=pos
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // cache 가 꽉 찼으면 (pos >= N) 아무것도 안 씀 - 호출 쪽에서 pos < N 보장
+    if (pos < 0 || pos >= N) return;
+
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // Q 타일 = 새 토큰 q 1 행
+    qint8_t tile_Q[1][dk];
+    #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+    scale_fixed_t tile_scale_Q[1];
+    decode_new_kv_t new_kv;
+    #pragma HLS ARRAY_PARTITION variable=new_kv.k cyclic factor=4
+    #pragma HLS ARRAY_PARTITION variable=new_kv.v cyclic factor=4
+    tile_scale_Q[0] = (scale_fixed_t)scale_q;
+    new_kv.scale_k = (scale_fixed_t)scale_k;
+    new_kv.scale_v = (scale_fixed_t)scale_v;
+
+    // 1. 새 토큰 q / k / v 로드 (head_dim 밖 열은 0)
+    LOAD_NEW:
+    for (int k = 0; k < dk; k++) {
+        #pragma HLS PIPELINE II=1
+        tile_Q[0][k] = (k < head_dim) ? q_new[k] : (qint8_t)0;
+        new_kv.k[k] = (k < head_dim) ? k_new[k] : (qint8_t)0;
+    }
+    for (int v = 0; v < dv; v++) {
+        #pragma HLS PIPELINE II=1
+        new_kv.v[v] = (v < head_dim) ? v_new[v] : (qint8_t)0;
+    }
+    DDR_READ(3 * head_dim * QINT8_BYTES);
+
+    // 2. KV cache append - 행 pos (head_dim 밖 열은 쓰지 않음)
+    APPEND_KV:
+    for (int k = 0; k < dk; k++) {
+        #pragma HLS PIPELINE II=1
+        if (k < head_dim) K_cache[pos][k] = new_kv.k[k];
+    }
+    for (int v = 0; v < dv; v++) {
+        #pragma HLS PIPELINE II=1
+        if (v < head_dim) V_cache[pos][v] = new_kv.v[v];
+    }
+    scale_K_cache[pos] = scale_k;
+    scale_V_cache[pos] = scale_v;
+    DDR_WRITE(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+
+    // 3. prefix [0, pos] 스트리밍 (블록 load 와 계산 overlap) 후 정규화 - 행 pos 하나짜리 Q 타일
+    kv_source_decode src = { K_cache, V_cache, scale_K_cache, scale_V_cache, &new_kv, pos, head_dim };
+    fixed_t tile_O[1][dv];
+    #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+    compute_q_tile_tmpl<attn_cfg_decode>(src, tile_Q, tile_scale_Q, pos, attn_scale, tile_O);
+
+    // 4. 출력 1 행 (WRITE_OUTPUT 과 같은 형식)
+#if INT8_OUTPUT
+    qint8_t q_out[dv];
+    quant_abs_t o_absmax = quant_row_absmax<dv>(tile_O[0], head_dim, q_out);
+    Output_scale[0] = quant_out_scale(o_absmax);
+    DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+    WRITE_OUTPUT:
+    for (int v = 0; v < dv; v++) {
+        #pragma HLS PIPELINE II=1
+        if (v < head_dim) Output[v] = q_out[v];
+    }
+#else
+    DDR_WRITE(head_dim * OUTPUT_BYTES);
+    WRITE_OUTPUT:
+    for (int v = 0; v < dv; v++) {
+        #pragma HLS PIPELINE II=1
+        if (v < head_dim) Output[v] = tile_O[0][v];
+    }
+#endif
+}
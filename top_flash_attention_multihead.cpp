@@ -0,0 +1,247 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// Multi-head / batched attention (MHA / GQA / MQA)
+// KV head 단위 DATAFLOW:  load_kv_head(g+1) | compute_group(g)
+//   - KV head 하나를 한 번만 로드해서 group 안의 query head 전부가 재사용
+//     (group = heads / kv_heads, MHA=1, MQA=heads) -> K/V 트래픽 1/group
+// KV head 버퍼는 KV_HEAD_LOOP 안에 선언되어 PIPO(ping-pong) 로 매핑됨
+// query head 하나의 datapath 는 flash_attention_tmpl.h (attn_cfg_default) - KV 는 head 버퍼에서 (kv_source_head)
+// --------------------------------------------------------
+
+// K 타일 경계까지 zero-fill 할 행 수 (Br, Bc 중 큰 값의 배수)
+#define HEAD_TILE ((Br > Bc) ? Br : Bc)
+
+// Load KV head 함수 - KV head bkv 의 K, V 와 scale 을 DDR 에서 온칩 버퍼로
+void load_kv_head(
+    qint8_t K[][N][dk],
+    qint8_t V[][N][dv],
+    float scale_K[][N],
+    float scale_V[][N],
+    int bkv,
+    int seq_len,
+    int head_dim,
+    qint8_t head_K[N][dk],
+    qint8_t head_V[N][dv],
+    scale_fixed_t head_scale_K[N],
+    scale_fixed_t head_scale_V[N]
+) {
+    #pragma HLS INLINE off
+
+    // 마지막 타일까지 채움 (seq_len 밖의 행, head_dim 밖의 열은 0)
+    int rows = ((seq_len + HEAD_TILE - 1) / HEAD_TILE) * HEAD_TILE;
+
+    LOAD_KV_HEAD:
+    for (int n = 0; n < rows; n++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N
+        #pragma HLS PIPELINE II=1
+        bool row_valid = (n < seq_len);
+        head_scale_K[n] = row_valid ? (scale_fixed_t)scale_K[bkv][n] : (scale_fixed_t)0;
+        head_scale_V[n] = row_valid ? (scale_fixed_t)scale_V[bkv][n] : (scale_fixed_t)0;
+        for (int k = 0; k < dk; k++) {
+            head_K[n][k] = (row_valid && k < head_dim) ? K[bkv][n][k] : (qint8_t)0;
+        }
+        for (int v = 0; v < dv; v++) {
+            head_V[n][v] = (row_valid && v < head_dim) ? V[bkv][n][v] : (qint8_t)0;
+        }
+        if (row_valid) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// Load KV 함수 - 온칩 KV head 버퍼의 블록 [j, j+Bc) 를 PIPO 버퍼로 (DDR 접근 없음, zero-fill 은 load_kv_head 에서 끝남)
+void load_kv_task_head(
+    qint8_t head_K[N][dk],
+    qint8_t head_V[N][dv],
+    scale_fixed_t head_scale_K[N],
+    scale_fixed_t head_scale_V[N],
+    int j,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        kv_scale_K[c] = head_scale_K[j + c];
+        kv_scale_V[c] = head_scale_V[j + c];
+        for (int k = 0; k < dk; k++) kv_K[c][k] = head_K[j + c][k];
+        for (int v = 0; v < dv; v++) kv_V[c][v] = head_V[j + c][v];
+    }
+}
+
+// KV source - KV head 버퍼 하나 (group 안의 query head 가 공유), 루프 범위 / 마스크는 DATAFLOW variant 와 같음
+struct kv_source_head {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*head_K)[dk];
+    qint8_t (*head_V)[dv];
+    scale_fixed_t* head_scale_K;
+    scale_fixed_t* head_scale_V;
+    int seq_len;
+    bool causal;
+
+    int first_block(int) const { return 0; }
+    int end_block(int i) const { return (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const { return attn_causal_mask(seq_len, is_diag_tile(i, j, causal)); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_head(head_K, head_V, head_scale_K, head_scale_V, j, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+// Compute group 함수 - 온칩 KV head 버퍼를 group 안의 query head 들이 차례로 사용
+// query head qh = b * heads + kvh * group + g
+// query head 마다 Q 타일 3-stage DATAFLOW:  load_q_task_tmpl(i+1) | compute_q_tile_tmpl(i) | write_output_task_tmpl(i-1)
+// INT8_OUTPUT 이면 query head 별 Output_scale[qh] 도 씀
+void compute_group(
+    qint8_t Q[][N][dk],
+    float scale_Q[][N],
+    out_t Output[][N][dv],
+#if INT8_OUTPUT
+    float Output_scale[][N],
+#endif
+    qint8_t head_K[N][dk],
+    qint8_t head_V[N][dv],
+    scale_fixed_t head_scale_K[N],
+    scale_fixed_t head_scale_V[N],
+    int q_head_base,
+    int group,
+    int seq_len,
+    int head_dim,
+    bool causal
+) {
+    #pragma HLS INLINE off
+
+    // 1/sqrt(head_dim) - head_dim=64 이면 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    kv_source_head src = { head_K, head_V, head_scale_K, head_scale_V, seq_len, causal };
+
+    int num_q_tiles = (seq_len + Br - 1) / Br;
+
+    GROUP_LOOP:
+    for (int g = 0; g < group; g++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_HEADS
+
+        int qh = q_head_base + g;
+
+        OUTER_Q_LOOP:
+        for (int ib = 0; ib < num_q_tiles; ib++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+            #pragma HLS DATAFLOW
+
+            int i = ib * Br;
+
+            // Q 타일 / 출력 타일 ping-pong 버퍼
+            qint8_t tile_Q[Br][dk];
+            #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+            #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+            scale_fixed_t tile_scale_Q[Br];
+            #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+            fixed_t tile_O[Br][dv];
+            #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+            load_q_task_tmpl<attn_cfg_default>(Q[qh], scale_Q[qh], i, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+            compute_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+#if INT8_OUTPUT
+            write_output_task_tmpl<attn_cfg_default>(tile_O, i, seq_len, head_dim, Output_scale[qh], Output[qh]);
+#else
+            write_output_task_tmpl<attn_cfg_default>(tile_O, i, seq_len, head_dim, Output[qh]);
+#endif
+        } // end OUTER_Q_LOOP
+    } // end GROUP_LOOP
+}
+
+
+void compute_attention_batched_HLS(
+    qint8_t Q[][N][dk],
+    qint8_t K[][N][dk],
+    qint8_t V[][N][dv],
+    out_t Output[][N][dv],
+    float scale_Q[][N],
+    float scale_K[][N],
+    float scale_V[][N],
+#if INT8_OUTPUT
+    float Output_scale[][N],
+#endif
+    int batch,
+    int heads,
+    int kv_heads,
+    int seq_len,
+    int head_dim,
+    bool causal
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=MAX_BATCH*MAX_HEADS*N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=MAX_BATCH*MAX_HEADS*N
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=MAX_BATCH*MAX_HEADS*N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_K bundle=gmem1 depth=MAX_BATCH*MAX_HEADS*N
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=MAX_BATCH*MAX_HEADS*N*dv
+    #pragma HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=MAX_BATCH*MAX_HEADS*N
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=MAX_BATCH*MAX_HEADS*N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=MAX_BATCH*MAX_HEADS*N
+#endif
+
+    #pragma HLS INTERFACE mode=s_axilite port=batch
+    #pragma HLS INTERFACE mode=s_axilite port=heads
+    #pragma HLS INTERFACE mode=s_axilite port=kv_heads
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // query head group 크기 (heads 는 kv_heads 의 배수) - 아니면 query head 매핑이 틀어지므로 아무것도 안 함
+    // batch / heads 가 m_axi depth (MAX_BATCH / MAX_HEADS) 밖이어도 아무것도 안 함
+    if (kv_heads <= 0 || heads <= 0 || heads > MAX_HEADS || heads % kv_heads != 0) return;
+    if (batch <= 0 || batch > MAX_BATCH) return;
+    const int group = heads / kv_heads;
+    const int num_kv_heads_total = batch * kv_heads;
+
+    KV_HEAD_LOOP:
+    for (int bkv = 0; bkv < num_kv_heads_total; bkv++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_BATCH*MAX_HEADS
+        #pragma HLS DATAFLOW
+
+        // KV head 버퍼 (PIPO) - URAM 매핑
+        qint8_t head_K[N][dk];
+        #pragma HLS BIND_STORAGE variable=head_K type=ram_2p impl=uram
+        #pragma HLS ARRAY_PARTITION variable=head_K cyclic factor=4 dim=2
+        qint8_t head_V[N][dv];
+        #pragma HLS BIND_STORAGE variable=head_V type=ram_2p impl=uram
+        #pragma HLS ARRAY_PARTITION variable=head_V cyclic factor=4 dim=2
+
+        scale_fixed_t head_scale_K[N];
+        scale_fixed_t head_scale_V[N];
+
+        // (b, kvh) -> group 의 첫 query head
+        int q_head_base = (bkv / kv_heads) * heads + (bkv % kv_heads) * group;
+
+        // Task 1: Load KV head bkv (한 번만)
+        load_kv_head(K, V, scale_K, scale_V, bkv, seq_len, head_dim,
+                     head_K, head_V, head_scale_K, head_scale_V);
+
+        // Task 2: group 안의 query head 전부 계산
+        compute_group(Q, scale_Q, Output,
+#if INT8_OUTPUT
+                      Output_scale,
+#endif
+                      head_K, head_V, head_scale_K, head_scale_V,
+                      q_head_base, group, seq_len, head_dim, causal);
+    } // end KV_HEAD_LOOP
+}
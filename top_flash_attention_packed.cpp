@@ -0,0 +1,253 @@
+#include "flash_attention_tmpl.h"
+
+#if INT8_OUTPUT
+#error "packed variant writes fixed_t Output beats only; build with INT8_OUTPUT=0"
+#endif
+
+// --------------------------------------------------------
+// violation_cleaned 의 128-bit packed 포트 버전
+// Q/K/V 는 beat 당 int8 16 개 (BUS_PACK_FACTOR), Output 은 beat 당 fixed_t 8 개 (OUT_PACK_FACTOR)
+// 64-byte 행 = 4 beat (기존 64 beat), 로컬 버퍼는 lane 수만큼 partition 해서 한 cycle 에 unpack
+// process / compute stage 는 flash_attention_tmpl.h (attn_cfg_default), 이 파일은 unpack 로더 / pack writeback 만
+// K/V 는 violation_cleaned 처럼 Q 타일마다 DDR 에서 스트리밍 (상주 버퍼 없음)
+// --------------------------------------------------------
+
+// Load Q 함수 - Q 타일 beat 를 unpack (head_dim 을 덮는 beat 만 읽고, 남는 lane 과 seq_len 밖의 행은 0)
+void load_q_task_packed(
+    bus_t Q[N][DK_BEATS],
+    float scale_Q[N],
+    int i,
+    int seq_len,
+    int head_dim,
+    qint8_t tile_Q[Br][dk],
+    scale_fixed_t tile_scale_Q[Br]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_Q_SCALE:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+        tile_scale_Q[r] = (i + r < seq_len) ? (scale_fixed_t)scale_Q[i + r] : (scale_fixed_t)0;
+        if (i + r < seq_len) {
+            DDR_READ(SCALE_BYTES);
+            DDR_READ_BEATS(1);
+        }
+    }
+
+    LOAD_Q_MATRIX:
+    for (int r = 0; r < Br; r++) {
+        for (int b = 0; b < DK_BEATS; b++) {
+            #pragma HLS PIPELINE II=1
+            bool beat_valid = (i + r < seq_len && b * BUS_PACK_FACTOR < head_dim);
+            bus_t beat = beat_valid ? Q[i + r][b] : (bus_t)0;
+            if (beat_valid) {
+                DDR_READ(BUS_BITS / 8);
+                DDR_READ_BEATS(1);
+            }
+            UNPACK_Q:
+            for (int l = 0; l < BUS_PACK_FACTOR; l++) {
+                #pragma HLS UNROLL
+                int k = b * BUS_PACK_FACTOR + l;
+                tile_Q[r][k] = (k < head_dim) ? (qint8_t)beat.range(8 * l + 7, 8 * l) : (qint8_t)0;
+            }
+        }
+    }
+}
+
+// Load KV 함수 - KV 블록 [j, j+Bc) 의 beat 를 PIPO 버퍼로 unpack (seq_len 밖 행, head_dim 밖 lane 은 0)
+void load_kv_task_packed(
+    bus_t K[N][DK_BEATS],
+    bus_t V[N][DV_BEATS],
+    float scale_K[N],
+    float scale_V[N],
+    int j,
+    int seq_len,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    // --- LOAD K PART ---
+    LOAD_K_SCALE:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        kv_scale_K[c] = (j + c < seq_len) ? (scale_fixed_t)scale_K[j + c] : (scale_fixed_t)0;
+        if (j + c < seq_len) {
+            DDR_READ(SCALE_BYTES);
+            DDR_READ_BEATS(1);
+        }
+    }
+
+    LOAD_K_MATRIX:
+    for (int c = 0; c < Bc; c++) {
+        for (int b = 0; b < DK_BEATS; b++) {
+            #pragma HLS PIPELINE II=1
+            bool beat_valid = (j + c < seq_len && b * BUS_PACK_FACTOR < head_dim);
+            bus_t beat = beat_valid ? K[j + c][b] : (bus_t)0;
+            if (beat_valid) {
+                DDR_READ(BUS_BITS / 8);
+                DDR_READ_BEATS(1);
+            }
+            UNPACK_K:
+            for (int l = 0; l < BUS_PACK_FACTOR; l++) {
+                #pragma HLS UNROLL
+                int k = b * BUS_PACK_FACTOR + l;
+                kv_K[c][k] = (k < head_dim) ? (qint8_t)beat.range(8 * l + 7, 8 * l) : (qint8_t)0;
+            }
+        }
+    }
+
+    // --- LOAD V PART ---
+    LOAD_V_SCALE:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        kv_scale_V[c] = (j + c < seq_len) ? (scale_fixed_t)scale_V[j + c] : (scale_fixed_t)0;
+        if (j + c < seq_len) {
+            DDR_READ(SCALE_BYTES);
+            DDR_READ_BEATS(1);
+        }
+    }
+
+    LOAD_V_MATRIX:
+    for (int c = 0; c < Bc; c++) {
+        for (int b = 0; b < DV_BEATS; b++) {
+            #pragma HLS PIPELINE II=1
+            bool beat_valid = (j + c < seq_len && b * BUS_PACK_FACTOR < head_dim);
+            bus_t beat = beat_valid ? V[j + c][b] : (bus_t)0;
+            if (beat_valid) {
+                DDR_READ(BUS_BITS / 8);
+                DDR_READ_BEATS(1);
+            }
+            UNPACK_V:
+            for (int l = 0; l < BUS_PACK_FACTOR; l++) {
+                #pragma HLS UNROLL
+                int v = b * BUS_PACK_FACTOR + l;
+                kv_V[c][v] = (v < head_dim) ? (qint8_t)beat.range(8 * l + 7, 8 * l) : (qint8_t)0;
+            }
+        }
+    }
+}
+
+// KV source - packed 포트 스트리밍, PIPO 버퍼는 beat lane 수만큼 partition
+struct kv_source_packed {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = BUS_PACK_FACTOR;
+
+    bus_t (*K)[DK_BEATS];
+    bus_t (*V)[DV_BEATS];
+    float* scale_K;
+    float* scale_V;
+    int seq_len;
+    int head_dim;
+    bool causal;
+
+    int first_block(int) const { return 0; }
+    int end_block(int i) const { return (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const { return attn_causal_mask(seq_len, is_diag_tile(i, j, causal)); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_packed(K, V, scale_K, scale_V, j, seq_len, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+// Write 함수 - beat 단위로 pack 해서 쓰기 - head_dim 을 덮는 beat 만, 남는 lane 은 0
+void write_output_task_packed(
+    fixed_t tile_O[Br][dv],
+    int i,
+    int seq_len,
+    int head_dim,
+    bus_t Output[N][DV_OUT_BEATS]
+) {
+    #pragma HLS INLINE off
+
+    WRITE_OUTPUT:
+    for (int r = 0; r < Br; r++) {
+        for (int b = 0; b < DV_OUT_BEATS; b++) {
+            #pragma HLS PIPELINE II=1
+            bus_t beat = 0;
+            PACK_OUTPUT:
+            for (int l = 0; l < OUT_PACK_FACTOR; l++) {
+                #pragma HLS UNROLL
+                int v = b * OUT_PACK_FACTOR + l;
+                fixed_t out = (v < head_dim) ? tile_O[r][v] : (fixed_t)0;
+                beat.range(16 * l + 15, 16 * l) = out.range(15, 0);
+            }
+            if (i + r < seq_len && b * OUT_PACK_FACTOR < head_dim) {
+                Output[i + r][b] = beat;
+                DDR_WRITE(BUS_BITS / 8);
+                DDR_WRITE_BEATS(1);
+            }
+        }
+    }
+}
+
+
+void compute_attention_packed_HLS(
+    bus_t Q[N][DK_BEATS],
+    bus_t K[N][DK_BEATS],
+    bus_t V[N][DV_BEATS],
+    bus_t Output[N][DV_OUT_BEATS],
+    float scale_Q[N],         
+    float scale_K[N],          
+    float scale_V[N],
+    int seq_len,
+    int head_dim,
+    bool causal
+) {
+
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=N*DK_BEATS
+    #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=N
+    
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=N*DK_BEATS
+    #pragma HLS INTERFACE mode=m_axi port=scale_K bundle=gmem1 depth=N
+    
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=N*DV_BEATS
+    #pragma HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=N
+    
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=N*DV_OUT_BEATS
+    
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // 1/sqrt(head_dim) - head_dim=64 이면 기존 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    kv_source_packed src = { K, V, scale_K, scale_V, seq_len, head_dim, causal };
+
+    int num_q_tiles = (seq_len + Br - 1) / Br;
+
+    OUTER_Q_LOOP:
+    for (int ib = 0; ib < num_q_tiles; ib++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+        #pragma HLS DATAFLOW
+
+        int i = ib * Br;
+
+        // Q 타일 / 출력 타일 ping-pong 버퍼 - beat 하나 (16 lane) 를 한 cycle 에 쓰도록 BUS_PACK_FACTOR 로 partition
+        qint8_t tile_Q[Br][dk];
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=BUS_PACK_FACTOR dim=2
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+        scale_fixed_t tile_scale_Q[Br];
+        #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+        fixed_t tile_O[Br][dv];
+        #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=OUT_PACK_FACTOR dim=2
+
+        load_q_task_packed(Q, scale_Q, i, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+        compute_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+        write_output_task_packed(tile_O, i, seq_len, head_dim, Output);
+    } // end OUTER_Q_LOOP
+}
@@ -0,0 +1,235 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// Paged KV cache variant
+// --------------------------------------------------------
+// K/V 가 연속 [N][dk] 배열이 아니라 page pool [KV_POOL_PAGES][KV_PAGE_ROWS][dk] 에 흩어져 있음
+// 시퀀스의 논리 KV 행 r 은 page block_table[r / KV_PAGE_ROWS] 의 (r % KV_PAGE_ROWS) 번째 행
+// KV_PAGE_ROWS 는 Bc 배수라 KV 타일 [j, j+Bc) 는 항상 page 하나 안 - 타일마다 table 한 번 보고 그 page 에서 바로 burst
+// host 가 staging 버퍼로 gather 할 필요 없음, 여러 시퀀스가 pool 하나를 공유 (block_table 만 다름)
+// 나머지 datapath (process / Q 타일 DATAFLOW / writeback) 는 flash_attention_tmpl.h 의 attn_cfg_default 그대로
+// 이 파일은 page 로더와 kv_source_paged 만
+
+// K/V 상주 로드 - page 를 따라가며 논리 행 [0, seq_len) 를 온칩 버퍼에 연속으로 모음
+void load_kv_resident_paged(
+    qint8_t K_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dk],
+    qint8_t V_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dv],
+    float scale_K_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+    float scale_V_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+    int page_table[KV_MAX_PAGES],
+    int seq_len,
+    int head_dim,
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV_RESIDENT:
+    for (int c = 0; c < seq_len; c++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=KV_RESIDENT_MAX
+        #pragma HLS PIPELINE II=1
+        int page = page_table[c / KV_PAGE_ROWS];
+        int off = c % KV_PAGE_ROWS;
+        res_scale_K[c] = (scale_fixed_t)scale_K_pool[page][off];
+        res_scale_V[c] = (scale_fixed_t)scale_V_pool[page][off];
+        for (int k = 0; k < dk; k++) {
+            res_K[c][k] = (k < head_dim) ? K_pool[page][off][k] : (qint8_t)0;
+        }
+        for (int v = 0; v < dv; v++) {
+            res_V[c][v] = (v < head_dim) ? V_pool[page][off][v] : (qint8_t)0;
+        }
+        DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// Load KV 함수 - KV 타일 [j, j+Bc) 를 PIPO 버퍼로 (seq_len 밖 행, head_dim 밖 열은 0)
+// 상주 모드면 온칩 버퍼, 아니면 타일이 있는 page 에서 직접 (page / offset 은 타일당 한 번)
+void load_kv_task_paged(
+    qint8_t K_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dk],
+    qint8_t V_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dv],
+    float scale_K_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+    float scale_V_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+    int page_table[KV_MAX_PAGES],
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX],
+    bool kv_resident,
+    int j,
+    int seq_len,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    int page = page_table[j / KV_PAGE_ROWS];
+    int base = j % KV_PAGE_ROWS;
+
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        int off = base + c;
+        bool row_valid = (kv_row < seq_len);
+        kv_scale_K[c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_K[kv_row] : (scale_fixed_t)scale_K_pool[page][off];
+        kv_scale_V[c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_V[kv_row] : (scale_fixed_t)scale_V_pool[page][off];
+        for (int k = 0; k < dk; k++) {
+            kv_K[c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : kv_resident ? res_K[kv_row][k] : K_pool[page][off][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            kv_V[c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : kv_resident ? res_V[kv_row][v] : V_pool[page][off][v];
+        }
+        if (row_valid && !kv_resident) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// KV source - 타일 [j, j+Bc) 는 page 하나 안 (load_kv_task_paged), 루프 범위 / 마스크는 DATAFLOW variant 와 같음
+struct kv_source_paged {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*K_pool)[KV_PAGE_ROWS][dk];
+    qint8_t (*V_pool)[KV_PAGE_ROWS][dv];
+    float (*scale_K_pool)[KV_PAGE_ROWS];
+    float (*scale_V_pool)[KV_PAGE_ROWS];
+    int* page_table;
+    qint8_t (*res_K)[dk];
+    qint8_t (*res_V)[dv];
+    scale_fixed_t* res_scale_K;
+    scale_fixed_t* res_scale_V;
+    bool kv_resident;
+    int seq_len;
+    int head_dim;
+    bool causal;
+
+    int first_block(int) const { return 0; }
+    int end_block(int i) const { return (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const { return attn_causal_mask(seq_len, is_diag_tile(i, j, causal)); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_paged(K_pool, V_pool, scale_K_pool, scale_V_pool, page_table, res_K, res_V, res_scale_K, res_scale_V,
+                           kv_resident, j, seq_len, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+
+void compute_attention_paged_HLS(
+    qint8_t Q[N][dk],
+    qint8_t K_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dk],
+    qint8_t V_pool[KV_POOL_PAGES][KV_PAGE_ROWS][dv],
+    out_t Output[N][dv],
+    float scale_Q[N],
+    float scale_K_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+    float scale_V_pool[KV_POOL_PAGES][KV_PAGE_ROWS],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int block_table[KV_MAX_PAGES],
+    int seq_len,
+    int head_dim,
+    bool causal
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=N
+    #pragma HLS INTERFACE mode=m_axi port=block_table bundle=gmem0 depth=KV_MAX_PAGES
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K_pool       bundle=gmem1 depth=KV_POOL_PAGES*KV_PAGE_ROWS*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_K_pool bundle=gmem1 depth=KV_POOL_PAGES*KV_PAGE_ROWS
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V_pool       bundle=gmem2 depth=KV_POOL_PAGES*KV_PAGE_ROWS*dv
+    #pragma HLS INTERFACE mode=m_axi port=scale_V_pool bundle=gmem2 depth=KV_POOL_PAGES*KV_PAGE_ROWS
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=N
+#endif
+
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // K/V 상주 버퍼 - URAM 매핑 (seq_len <= KV_RESIDENT_MAX 일 때 사용)
+    qint8_t res_K[KV_RESIDENT_MAX][dk];
+    #pragma HLS BIND_STORAGE variable=res_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_K cyclic factor=4 dim=2
+    qint8_t res_V[KV_RESIDENT_MAX][dv];
+    #pragma HLS BIND_STORAGE variable=res_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_V cyclic factor=4 dim=2
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX];
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX];
+
+    // 1/sqrt(head_dim) - head_dim=64 이면 기존 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // block table 은 시작할 때 온칩으로 (시퀀스당 KV_MAX_PAGES 개, 타일마다 DDR 왕복 없이 조회)
+    // [0, KV_POOL_PAGES) 밖의 page index 는 page 0 으로 (pool 밖 주소를 읽지 않음, 결과는 host 책임)
+    int page_table[KV_MAX_PAGES];
+    #pragma HLS ARRAY_PARTITION variable=page_table complete
+
+    int num_pages = (seq_len + KV_PAGE_ROWS - 1) / KV_PAGE_ROWS;
+
+    LOAD_BLOCK_TABLE:
+    for (int p = 0; p < KV_MAX_PAGES; p++) {
+        #pragma HLS PIPELINE II=1
+        int page = (p < num_pages) ? block_table[p] : 0;
+        page_table[p] = (page >= 0 && page < KV_POOL_PAGES) ? page : 0;
+        if (p < num_pages) DDR_READ(BLOCK_TABLE_BYTES);
+    }
+
+    // K/V 상주 모드: 전체 K/V 를 한 번만 DDR 에서 읽고 모든 Q 타일에서 재사용
+    // (스트리밍 모드는 Q 타일마다 K/V 전체를 다시 읽음 -> N/Br 배 트래픽)
+    bool kv_resident = (seq_len <= KV_RESIDENT_MAX);
+
+    if (kv_resident) {
+        load_kv_resident_paged(K_pool, V_pool, scale_K_pool, scale_V_pool, page_table, seq_len, head_dim,
+                               res_K, res_V, res_scale_K, res_scale_V);
+    }
+
+    kv_source_paged src = { K_pool, V_pool, scale_K_pool, scale_V_pool, page_table,
+                            res_K, res_V, res_scale_K, res_scale_V, kv_resident, seq_len, head_dim, causal };
+
+    int num_q_tiles = (seq_len + Br - 1) / Br;
+
+    OUTER_Q_LOOP:
+    for (int ib = 0; ib < num_q_tiles; ib++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+        #pragma HLS DATAFLOW
+
+        int i = ib * Br;
+
+        // Q 타일 / 출력 타일 ping-pong 버퍼
+        qint8_t tile_Q[Br][dk];
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+        scale_fixed_t tile_scale_Q[Br];
+        #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+        fixed_t tile_O[Br][dv];
+        #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+        // Stage 1: Q 타일 i 로드 (앞 타일 계산과 overlap)
+        load_q_task_tmpl<attn_cfg_default>(Q, scale_Q, i, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+        // Stage 2: Q 타일 i 계산 (KV 루프 + 정규화)
+        compute_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+        // Stage 3: Q 타일 i 출력 writeback (다음 타일 계산과 overlap)
+#if INT8_OUTPUT
+        write_output_task_tmpl<attn_cfg_default>(tile_O, i, seq_len, head_dim, Output_scale, Output);
+#else
+        write_output_task_tmpl<attn_cfg_default>(tile_O, i, seq_len, head_dim, Output);
+#endif
+    } // end OUTER_Q_LOOP
+}
@@ -0,0 +1,240 @@
+#include "flash_attention_tmpl.h"
+
+#if INT8_OUTPUT
+#error "quant variant writes fixed_t Output only; build with INT8_OUTPUT=0"
+#endif
+
+// DATAFLOW variant 에 양자화 front end 를 합친 버전
+// 입력은 fixed_t 활성값 - LOAD_Q / LOAD_KV 가 DDR 에서 행을 읽으면서 quant_row 로 int8 + scale 생성
+// (offline 양자화 pass 의 fixed_t 읽기 + int8/scale 쓰기 + int8/scale 다시 읽기가 DDR 읽기 한 번으로)
+// 상주 모드면 K/V 는 load_kv_resident_quant 에서 한 번만 양자화, 모든 Q 타일이 재사용
+// 양자화 뒤 datapath 는 flash_attention_tmpl.h (attn_cfg_default) 의 process / compute stage
+
+// K/V 상주 로드 함수 - 전체 K, V 를 DDR 에서 한 번만 읽어서 양자화 후 온칩(URAM) 버퍼에 저장
+void load_kv_resident_quant(
+    fixed_t K[N][dk],
+    fixed_t V[N][dv],
+    int seq_len,
+    int head_dim,
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV_RESIDENT:
+    for (int c = 0; c < seq_len; c++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=KV_RESIDENT_MAX
+        #pragma HLS PIPELINE II=1
+        res_scale_K[c] = quant_row<dk>(K[c], head_dim, res_K[c]);
+        res_scale_V[c] = quant_row<dv>(V[c], head_dim, res_V[c]);
+        DDR_READ(2 * head_dim * ACT_BYTES);
+    }
+}
+
+// Load KV 함수 - K, V 블록을 PIPO 버퍼 (kv_K, kv_V, scale) 에 바로 씀
+// 상주 모드면 온칩 버퍼 (양자화 완료) 에서, 아니면 DDR 에서 읽으면서 양자화
+void load_kv_task_quant(
+    fixed_t K[N][dk],
+    fixed_t V[N][dv],
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX],
+    bool kv_resident,
+    int j,
+    int seq_len,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    // seq_len 밖의 행, head_dim 밖의 열은 0
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        bool row_valid = (kv_row < seq_len);
+        if (row_valid && !kv_resident) {
+            kv_scale_K[c] = quant_row<dk>(K[kv_row], head_dim, kv_K[c]);
+            kv_scale_V[c] = quant_row<dv>(V[kv_row], head_dim, kv_V[c]);
+            DDR_READ(2 * head_dim * ACT_BYTES);
+        } else {
+            kv_scale_K[c] = row_valid ? res_scale_K[kv_row] : (scale_fixed_t)0;
+            kv_scale_V[c] = row_valid ? res_scale_V[kv_row] : (scale_fixed_t)0;
+            for (int k = 0; k < dk; k++) {
+                kv_K[c][k] = (row_valid && k < head_dim) ? res_K[kv_row][k] : (qint8_t)0;
+            }
+            for (int v = 0; v < dv; v++) {
+                kv_V[c][v] = (row_valid && v < head_dim) ? res_V[kv_row][v] : (qint8_t)0;
+            }
+        }
+    }
+}
+
+// KV source - 로더만 양자화 (load_kv_task_quant), 루프 범위 / 마스크는 DATAFLOW variant 와 같음
+struct kv_source_quant {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = 4;
+
+    fixed_t (*K)[dk];
+    fixed_t (*V)[dv];
+    qint8_t (*res_K)[dk];
+    qint8_t (*res_V)[dv];
+    scale_fixed_t* res_scale_K;
+    scale_fixed_t* res_scale_V;
+    bool kv_resident;
+    int seq_len;
+    int head_dim;
+    bool causal;
+
+    int first_block(int) const { return 0; }
+    int end_block(int i) const { return (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const { return attn_causal_mask(seq_len, is_diag_tile(i, j, causal)); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_quant(K, V, res_K, res_V, res_scale_K, res_scale_V,
+                           kv_resident, j, seq_len, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+// --------------------------------------------------------
+// Q 타일 단위 3-stage DATAFLOW:  load_q_task_quant(i+1) | compute_q_tile_tmpl(i) | write_output_task_quant(i-1)
+// tile 버퍼 (tile_Q, tile_scale_Q, tile_O) 는 OUTER_Q_LOOP 안에 선언되어 PIPO(ping-pong) 로 매핑됨
+// --------------------------------------------------------
+
+// Load Q 함수 - Q 타일을 DDR 에서 읽으면서 양자화 (seq_len 밖의 행, head_dim 밖의 열은 0)
+void load_q_task_quant(
+    fixed_t Q[N][dk],
+    int i,
+    int seq_len,
+    int head_dim,
+    qint8_t tile_Q[Br][dk],
+    scale_fixed_t tile_scale_Q[Br]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_Q:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+        bool row_valid = (i + r < seq_len);
+        if (row_valid) {
+            tile_scale_Q[r] = quant_row<dk>(Q[i + r], head_dim, tile_Q[r]);
+            DDR_READ(head_dim * ACT_BYTES);
+        } else {
+            tile_scale_Q[r] = 0;
+            for (int k = 0; k < dk; k++) {
+                tile_Q[r][k] = 0;
+            }
+        }
+    }
+}
+
+// Write 함수 - 정규화된 출력 타일을 DDR 로 (seq_len / head_dim 밖은 쓰지 않음)
+void write_output_task_quant(
+    fixed_t tile_O[Br][dv],
+    int i,
+    int seq_len,
+    int head_dim,
+    fixed_t Output[N][dv]
+) {
+    #pragma HLS INLINE off
+
+    WRITE_OUTPUT:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+        if (i + r < seq_len) DDR_WRITE(head_dim * OUTPUT_BYTES);
+        for (int v = 0; v < dv; v++) {
+            if (i + r < seq_len && v < head_dim) {
+                Output[i + r][v] = tile_O[r][v];
+            }
+        }
+    }
+}
+
+
+void compute_attention_quant_HLS(
+    fixed_t Q[N][dk],
+    fixed_t K[N][dk],
+    fixed_t V[N][dv],
+    fixed_t Output[N][dv],
+    int seq_len,
+    int head_dim,
+    bool causal
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=N*dk
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=N*dk
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=N*dv
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=N*dv
+
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // K/V 상주 버퍼 - URAM 매핑 (seq_len <= KV_RESIDENT_MAX 일 때 사용)
+    qint8_t res_K[KV_RESIDENT_MAX][dk];
+    #pragma HLS BIND_STORAGE variable=res_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_K cyclic factor=4 dim=2
+    qint8_t res_V[KV_RESIDENT_MAX][dv];
+    #pragma HLS BIND_STORAGE variable=res_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_V cyclic factor=4 dim=2
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX];
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX];
+
+    // 1/sqrt(head_dim) - head_dim=64 이면 기존 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // K/V 상주 모드: 전체 K/V 를 한 번만 DDR 에서 읽고 모든 Q 타일에서 재사용
+    // (스트리밍 모드는 Q 타일마다 K/V 전체를 다시 읽음 -> N/Br 배 트래픽)
+    bool kv_resident = (seq_len <= KV_RESIDENT_MAX);
+
+    if (kv_resident) {
+        load_kv_resident_quant(K, V, seq_len, head_dim,
+                               res_K, res_V, res_scale_K, res_scale_V);
+    }
+
+    kv_source_quant src = { K, V, res_K, res_V, res_scale_K, res_scale_V, kv_resident, seq_len, head_dim, causal };
+
+    int num_q_tiles = (seq_len + Br - 1) / Br;
+
+    OUTER_Q_LOOP:
+    for (int ib = 0; ib < num_q_tiles; ib++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+        #pragma HLS DATAFLOW
+
+        int i = ib * Br;
+
+        // Q 타일 / 출력 타일 ping-pong 버퍼
+        qint8_t tile_Q[Br][dk];
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+        scale_fixed_t tile_scale_Q[Br];
+        #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+        fixed_t tile_O[Br][dv];
+        #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+        // Stage 1: Q 타일 i 로드 + 양자화 (앞 타일 계산과 overlap)
+        load_q_task_quant(Q, i, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+        // Stage 2: Q 타일 i 계산 (KV 루프 + 정규화)
+        compute_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+        // Stage 3: Q 타일 i 출력 writeback (다음 타일 계산과 overlap)
+        write_output_task_quant(tile_O, i, seq_len, head_dim, Output);
+    } // end OUTER_Q_LOOP
+}
@@ -0,0 +1,404 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// Split-KV (flash-decoding) variant
+// --------------------------------------------------------
+// compute_attention_splitkv_HLS : KV 범위 [kv_start, kv_end) 청크 하나만 보고 Q 행 [q_start, q_start + q_len) 에 대해
+//   정규화 전 출력 (local_O) + softmax 통계 (local_m, local_l) 를 partial 로 씀
+//   Q 범위는 KV 길이와 별개 - decode 는 q_len = 1 (마지막 토큰) 이라 청크마다 Q 는 한 행만 읽음
+//   청크끼리 독립이라 청크마다 다른 compute unit 에서 동시에 실행 가능
+//   (Q 행이 적고 seq_len 이 긴 decode 에서 OUTER_KV_LOOP 하나만 도는 것보다 병렬도 확보)
+// combine_splitkv_HLS : partial 들을 logsumexp 로 합쳐서 최종 출력
+//   M = max m_s,  l = sum l_s * e^(m_s - M),  O = sum O_s * e^(m_s - M) / l
+// 청크 내부 datapath 는 DATAFLOW variant 와 같음 (flash_attention_tmpl.h 의 accumulate_q_tile_tmpl, Q 타일 단위)
+// 이 파일은 청크 로더, kv_source_splitkv, partial 출력 / combine 만
+
+// 청크 K/V 상주 로드 - 청크 행 [kv_start, kv_end) 를 한 번만 읽어서 온칩 버퍼 [0, kv_end - kv_start) 에
+void load_kv_chunk_splitkv(
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    float scale_K[N],
+    float scale_V[N],
+    int kv_start,
+    int kv_end,
+    int head_dim,
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV_CHUNK:
+    for (int c = 0; c < kv_end - kv_start; c++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=KV_RESIDENT_MAX
+        #pragma HLS PIPELINE II=1
+        int kv_row = kv_start + c;
+        res_scale_K[c] = (scale_fixed_t)scale_K[kv_row];
+        res_scale_V[c] = (scale_fixed_t)scale_V[kv_row];
+        for (int k = 0; k < dk; k++) {
+            res_K[c][k] = (k < head_dim) ? K[kv_row][k] : (qint8_t)0;
+        }
+        for (int v = 0; v < dv; v++) {
+            res_V[c][v] = (v < head_dim) ? V[kv_row][v] : (qint8_t)0;
+        }
+        DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// Load KV 함수 - KV 블록 [j, j+Bc) 를 PIPO 버퍼로 (청크 밖 행, head_dim 밖 열은 0)
+// 상주 모드면 온칩 버퍼 (index = kv_row - kv_start), 아니면 DDR
+void load_kv_task_splitkv(
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    float scale_K[N],
+    float scale_V[N],
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX],
+    bool kv_resident,
+    int j,
+    int kv_start,
+    int kv_end,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        int res_row = kv_row - kv_start;
+        bool row_valid = (kv_row < kv_end);
+        kv_scale_K[c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_K[res_row] : (scale_fixed_t)scale_K[kv_row];
+        kv_scale_V[c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_V[res_row] : (scale_fixed_t)scale_V[kv_row];
+        for (int k = 0; k < dk; k++) {
+            kv_K[c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : kv_resident ? res_K[res_row][k] : K[kv_row][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            kv_V[c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : kv_resident ? res_V[res_row][v] : V[kv_row][v];
+        }
+        if (row_valid && !kv_resident) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// KV source - 청크 [kv_start, kv_end) 안의 블록만 (causal 이면 대각 블록 끝에서도 멈춤), 마스킹 경계는 청크 끝
+// 청크 전체가 대각 뒤면 블록 0 개 (m = -10000, l = 0, O = 0)
+struct kv_source_splitkv {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*K)[dk];
+    qint8_t (*V)[dv];
+    float* scale_K;
+    float* scale_V;
+    qint8_t (*res_K)[dk];
+    qint8_t (*res_V)[dv];
+    scale_fixed_t* res_scale_K;
+    scale_fixed_t* res_scale_V;
+    bool kv_resident;
+    int seq_len;
+    int head_dim;
+    bool causal;
+    int kv_start;
+    int kv_end;
+
+    int first_block(int) const { return 0; }
+    int end_block(int i) const {
+        int kv_stop = kv_range_end(i, seq_len, causal);
+        if (kv_stop > kv_end) kv_stop = kv_end;
+        return (kv_stop > kv_start) ? (kv_stop - kv_start + Bc - 1) / Bc : 0;
+    }
+    int block_row(int, int jb) const { return kv_start + jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const { return attn_causal_mask(kv_end, is_diag_tile(i, j, causal)); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_splitkv(K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                             kv_resident, j, kv_start, kv_end, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+
+// --------------------------------------------------------
+// Q 타일 단위 3-stage DATAFLOW:  load_q_task_tmpl(i+1) | compute_q_tile_splitkv(i) | write_partial_task(i-1)
+// --------------------------------------------------------
+
+// Compute 함수 - Q 타일 하나에 대해 청크 안의 KV 블록을 누적 (accumulate_q_tile_tmpl) 하고 정규화 없이 통계와 함께 넘김
+void compute_q_tile_splitkv(
+    const kv_source_splitkv& src,
+    qint8_t tile_Q[Br][dk],
+    scale_fixed_t tile_scale_Q[Br],
+    int i,
+    scale_fixed_t attn_scale,
+    calc_t tile_O[Br][dv],
+    calc_t tile_m[Br],
+    calc_t tile_l[Br]
+) {
+    #pragma HLS INLINE off
+
+    calc_t local_O[Br][dv];
+    #pragma HLS ARRAY_PARTITION variable=local_O cyclic factor=NUM_ROW_ENGINES dim=1
+    calc_t local_m[Br];
+    #pragma HLS ARRAY_PARTITION variable=local_m complete
+    calc_t local_l[Br];
+    #pragma HLS ARRAY_PARTITION variable=local_l complete
+
+    accumulate_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, local_O, local_m, local_l);
+
+    // 정규화 없이 그대로 (combine 에서 1 / l)
+    EMIT_PARTIAL:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+        tile_m[r] = local_m[r];
+        tile_l[r] = local_l[r];
+        for (int v = 0; v < dv; v++) {
+            tile_O[r][v] = local_O[r][v];
+        }
+    }
+}
+
+// Write 함수 - partial 출력 / 통계를 DDR 로 (Q 범위 끝 q_end / head_dim 밖은 쓰지 않음)
+void write_partial_task(
+    calc_t tile_O[Br][dv],
+    calc_t tile_m[Br],
+    calc_t tile_l[Br],
+    int i,
+    int q_end,
+    int head_dim,
+    calc_t Partial_O[N][dv],
+    calc_t Partial_m[N],
+    calc_t Partial_l[N]
+) {
+    #pragma HLS INLINE off
+
+    WRITE_PARTIAL:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+        if (i + r < q_end) {
+            Partial_m[i + r] = tile_m[r];
+            Partial_l[i + r] = tile_l[r];
+            DDR_WRITE(head_dim * PARTIAL_BYTES + 2 * PARTIAL_BYTES);
+        }
+        for (int v = 0; v < dv; v++) {
+            if (i + r < q_end && v < head_dim) {
+                Partial_O[i + r][v] = tile_O[r][v];
+            }
+        }
+    }
+}
+
+
+void compute_attention_splitkv_HLS(
+    qint8_t Q[N][dk],
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    float scale_Q[N],
+    float scale_K[N],
+    float scale_V[N],
+    calc_t Partial_O[N][dv],
+    calc_t Partial_m[N],
+    calc_t Partial_l[N],
+    int seq_len,
+    int head_dim,
+    bool causal,
+    int kv_start,
+    int kv_end,
+    int q_start,
+    int q_len
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=N
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_K bundle=gmem1 depth=N
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=N*dv
+    #pragma HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=N
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Partial_O bundle=gmem3 depth=N*dv
+    #pragma HLS INTERFACE mode=m_axi port=Partial_m bundle=gmem3 depth=N
+    #pragma HLS INTERFACE mode=m_axi port=Partial_l bundle=gmem3 depth=N
+
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=kv_start
+    #pragma HLS INTERFACE mode=s_axilite port=kv_end
+    #pragma HLS INTERFACE mode=s_axilite port=q_start
+    #pragma HLS INTERFACE mode=s_axilite port=q_len
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // 청크 K/V 상주 버퍼 - URAM (청크 길이 <= KV_RESIDENT_MAX 일 때)
+    qint8_t res_K[KV_RESIDENT_MAX][dk];
+    #pragma HLS BIND_STORAGE variable=res_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_K cyclic factor=4 dim=2
+    qint8_t res_V[KV_RESIDENT_MAX][dv];
+    #pragma HLS BIND_STORAGE variable=res_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_V cyclic factor=4 dim=2
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX];
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX];
+
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // 청크는 seq_len 안으로 자름
+    if (kv_end > seq_len) kv_end = seq_len;
+    if (kv_start < 0) kv_start = 0;
+
+    // Q 범위 [q_start, q_end) 도 seq_len 안으로 (q_start + q_len overflow 없이)
+    if (q_start < 0) q_start = 0;
+    int q_end = (q_len > seq_len - q_start) ? seq_len : q_start + q_len;
+
+    bool kv_resident = (kv_end - kv_start <= KV_RESIDENT_MAX);
+
+    if (kv_resident && kv_end > kv_start) {
+        load_kv_chunk_splitkv(K, V, scale_K, scale_V, kv_start, kv_end, head_dim,
+                              res_K, res_V, res_scale_K, res_scale_V);
+    }
+
+    kv_source_splitkv src = { K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                              kv_resident, seq_len, head_dim, causal, kv_start, kv_end };
+
+    // Q 타일은 q_start 부터 (Br 정렬 아님 - 마스킹은 절대 행 번호 기준)
+    int num_q_tiles = (q_end > q_start) ? (q_end - q_start + Br - 1) / Br : 0;
+
+    OUTER_Q_LOOP:
+    for (int ib = 0; ib < num_q_tiles; ib++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+        #pragma HLS DATAFLOW
+
+        int i = q_start + ib * Br;
+
+        qint8_t tile_Q[Br][dk];
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+        scale_fixed_t tile_scale_Q[Br];
+        #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+        calc_t tile_O[Br][dv];
+        #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+        calc_t tile_m[Br];
+        calc_t tile_l[Br];
+
+        load_q_task_tmpl<attn_cfg_default>(Q, scale_Q, i, q_end, head_dim, tile_Q, tile_scale_Q);
+
+        compute_q_tile_splitkv(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O, tile_m, tile_l);
+
+        write_partial_task(tile_O, tile_m, tile_l, i, q_end, head_dim, Partial_O, Partial_m, Partial_l);
+    }
+}
+
+
+// --------------------------------------------------------
+// Combine - 청크 partial 을 logsumexp 로 합침 (행 단위, 청크 순서와 무관, Q 범위 행만)
+// 빈 청크 (m = -10000, l = 0) 는 weight 0 이 되어 자동으로 빠짐
+// num_splits == 1 이면 weight = exp(0) = 1 이라 단일 패스 커널과 bit 단위로 같음
+// --------------------------------------------------------
+void combine_splitkv_HLS(
+    calc_t Partial_O[MAX_KV_SPLITS][N][dv],
+    calc_t Partial_m[MAX_KV_SPLITS][N],
+    calc_t Partial_l[MAX_KV_SPLITS][N],
+    out_t Output[N][dv],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int num_splits,
+    int seq_len,
+    int head_dim,
+    int q_start,
+    int q_len
+) {
+    #pragma HLS INTERFACE mode=m_axi port=Partial_O bundle=gmem0 depth=MAX_KV_SPLITS*N*dv
+    #pragma HLS INTERFACE mode=m_axi port=Partial_m bundle=gmem1 depth=MAX_KV_SPLITS*N
+    #pragma HLS INTERFACE mode=m_axi port=Partial_l bundle=gmem1 depth=MAX_KV_SPLITS*N
+    #pragma HLS INTERFACE mode=m_axi port=Output    bundle=gmem2 depth=N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem2 depth=N
+#endif
+    #pragma HLS INTERFACE mode=s_axilite port=num_splits
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=q_start
+    #pragma HLS INTERFACE mode=s_axilite port=q_len
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // partial 버퍼는 MAX_KV_SPLITS 청크까지, 합칠 청크가 없으면 출력 없음
+    if (num_splits > MAX_KV_SPLITS) num_splits = MAX_KV_SPLITS;
+    if (num_splits <= 0) return;
+
+    // 청크 커널과 같은 Q 범위
+    if (q_start < 0) q_start = 0;
+    int q_end = (q_len > seq_len - q_start) ? seq_len : q_start + q_len;
+
+    COMBINE_ROW:
+    for (int i = q_start; i < q_end; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N
+
+        // 1. 전체 max
+        ap_fixed<32,16> m_max = -10000.0;
+        COMBINE_MAX:
+        for (int s = 0; s < num_splits; s++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_KV_SPLITS
+            #pragma HLS PIPELINE II=1
+            if (Partial_m[s][i] > m_max) m_max = Partial_m[s][i];
+        }
+
+        // 2. 청크별 weight e^(m_s - M) 로 l, O 누적
+        ap_fixed<32,16> l_sum = 0;
+        ap_fixed<32,16> o_acc[dv];
+        #pragma HLS ARRAY_PARTITION variable=o_acc cyclic factor=4
+        for (int v = 0; v < dv; v++) {
+            #pragma HLS PIPELINE II=1
+            o_acc[v] = 0;
+        }
+
+        COMBINE_SPLIT:
+        for (int s = 0; s < num_splits; s++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_KV_SPLITS
+            ap_fixed<32,16> w = attn_exp(Partial_m[s][i] - m_max);
+            l_sum += Partial_l[s][i] * w;
+            DDR_READ(head_dim * PARTIAL_BYTES + 2 * PARTIAL_BYTES);
+
+            COMBINE_ACC:
+            for (int v = 0; v < dv; v++) {
+                #pragma HLS PIPELINE II=1
+                if (v < head_dim) o_acc[v] += Partial_O[s][i][v] * w;
+            }
+        }
+
+        // 3. 정규화 + 출력 (WRITE_OUTPUT 과 같은 형식)
+        ap_fixed<32,16> inv_sum = attn_recip(l_sum);
+#if INT8_OUTPUT
+        fixed_t o_row[dv];
+        qint8_t q_row[dv];
+        for (int v = 0; v < dv; v++) {
+            #pragma HLS PIPELINE II=1
+            o_row[v] = (fixed_t)(o_acc[v] * inv_sum);
+        }
+        quant_abs_t o_absmax = quant_row_absmax<dv>(o_row, head_dim, q_row);
+        Output_scale[i] = quant_out_scale(o_absmax);
+        DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+        COMBINE_WRITE:
+        for (int v = 0; v < dv; v++) {
+            #pragma HLS PIPELINE II=1
+            if (v < head_dim) Output[i][v] = q_row[v];
+        }
+#else
+        DDR_WRITE(head_dim * OUTPUT_BYTES);
+        COMBINE_WRITE:
+        for (int v = 0; v < dv; v++) {
+            #pragma HLS PIPELINE II=1
+            if (v < head_dim) Output[i][v] = (fixed_t)(o_acc[v] * inv_sum);
+        }
+#endif
+    }
+}
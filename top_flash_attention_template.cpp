@@ -0,0 +1,85 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// 템플릿 kernel (flash_attention_tmpl.h) 의 explicit instantiation + HLS top wrapper
+// --------------------------------------------------------
+// config 마다 top 함수 하나 (v++ 로 여러 kernel 을 한 xclbin 에 link)
+// compute_attention_HLS 는 attn_cfg_default - DATAFLOW variant 와 같은 kernel (host_optimized / bench 에 그대로 사용)
+// INTERFACE pragma 는 top 함수 인자에만 적용돼서 wrapper 를 매크로로 생성 (_Pragma 로 depth 상수 전개)
+
+template ATTN_TMPL_INSTANCE(attn_cfg_d64_b16);
+template ATTN_TMPL_INSTANCE(attn_cfg_d64_b32);
+template ATTN_TMPL_INSTANCE(attn_cfg_d64_b64);
+template ATTN_TMPL_INSTANCE(attn_cfg_d128_b16);
+template ATTN_TMPL_INSTANCE(attn_cfg_d128_b32);
+template ATTN_TMPL_INSTANCE(attn_cfg_d128_b64);
+template ATTN_TMPL_INSTANCE(attn_cfg_d64_b32_wide);
+
+
+#define ATTN_PRAGMA(x) _Pragma(#x)
+
+#if INT8_OUTPUT
+#define ATTN_OUTPUT_SCALE_PARAM(NMAX_)      float Output_scale[NMAX_],
+#define ATTN_OUTPUT_SCALE_ARG               Output_scale,
+#define ATTN_OUTPUT_SCALE_INTERFACE(NMAX_)  ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=NMAX_)
+#else
+#define ATTN_OUTPUT_SCALE_PARAM(NMAX_)
+#define ATTN_OUTPUT_SCALE_ARG
+#define ATTN_OUTPUT_SCALE_INTERFACE(NMAX_)
+#endif
+
+#if BLOCK_SPARSE
+#define ATTN_BLOCK_LIST_PARAM(NMAX_, BR_, BC_)  int kv_block_ptr[NMAX_ / BR_ + 1], int kv_block_idx[(NMAX_ / BR_) * (NMAX_ / BC_)],
+#define ATTN_BLOCK_LIST_ARG                     kv_block_ptr, kv_block_idx,
+#define ATTN_BLOCK_LIST_INTERFACE(NMAX_, BR_, BC_)                                                   \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=kv_block_ptr bundle=gmem0 depth=NMAX_/BR_+1)          \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=kv_block_idx bundle=gmem0 depth=(NMAX_/BR_)*(NMAX_/BC_))
+#else
+#define ATTN_BLOCK_LIST_PARAM(NMAX_, BR_, BC_)
+#define ATTN_BLOCK_LIST_ARG
+#define ATTN_BLOCK_LIST_INTERFACE(NMAX_, BR_, BC_)
+#endif
+
+// 포트 / bundle 배치는 DATAFLOW variant 와 동일 (gmem0 Q, gmem1 K, gmem2 V, gmem3 Output)
+#define ATTN_TEMPLATE_TOP(NAME, CFG, NMAX_, DK_, DV_, BR_, BC_)                                      \
+void NAME(                                                                                          \
+    qint8_t Q[NMAX_][DK_],                                                                          \
+    qint8_t K[NMAX_][DK_],                                                                          \
+    qint8_t V[NMAX_][DV_],                                                                          \
+    CFG::out_type Output[NMAX_][DV_],                                                               \
+    float scale_Q[NMAX_],                                                                           \
+    float scale_K[NMAX_],                                                                           \
+    float scale_V[NMAX_],                                                                           \
+    ATTN_OUTPUT_SCALE_PARAM(NMAX_)                                                                  \
+    ATTN_BLOCK_LIST_PARAM(NMAX_, BR_, BC_)                                                          \
+    int seq_len,                                                                                    \
+    int head_dim,                                                                                   \
+    bool causal                                                                                     \
+) {                                                                                                 \
+    static_assert(CFG::NMAX == NMAX_ && CFG::DK == DK_ && CFG::DV == DV_ &&                         \
+                  CFG::BR == BR_ && CFG::BC == BC_, "wrapper shape mismatch");                      \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=NMAX_*DK_)                 \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=NMAX_)                     \
+    ATTN_BLOCK_LIST_INTERFACE(NMAX_, BR_, BC_)                                                      \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=NMAX_*DK_)                 \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=scale_K bundle=gmem1 depth=NMAX_)                     \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=NMAX_*DV_)                 \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=NMAX_)                     \
+    ATTN_PRAGMA(HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=NMAX_*DV_)                 \
+    ATTN_OUTPUT_SCALE_INTERFACE(NMAX_)                                                              \
+    ATTN_PRAGMA(HLS INTERFACE mode=s_axilite port=seq_len)                                          \
+    ATTN_PRAGMA(HLS INTERFACE mode=s_axilite port=head_dim)                                         \
+    ATTN_PRAGMA(HLS INTERFACE mode=s_axilite port=causal)                                           \
+    ATTN_PRAGMA(HLS INTERFACE mode=s_axilite port=return)                                           \
+    compute_attention_tmpl<CFG>(Q, K, V, Output, scale_Q, scale_K, scale_V, ATTN_OUTPUT_SCALE_ARG  \
+                                ATTN_BLOCK_LIST_ARG seq_len, head_dim, causal);                     \
+}
+
+ATTN_TEMPLATE_TOP(compute_attention_HLS,              attn_cfg_default,      N, dk,  dv,  Br, Bc)
+ATTN_TEMPLATE_TOP(compute_attention_d64_b16_HLS,      attn_cfg_d64_b16,      N, 64,  64,  16, 16)
+ATTN_TEMPLATE_TOP(compute_attention_d64_b32_HLS,      attn_cfg_d64_b32,      N, 64,  64,  32, 32)
+ATTN_TEMPLATE_TOP(compute_attention_d64_b64_HLS,      attn_cfg_d64_b64,      N, 64,  64,  64, 64)
+ATTN_TEMPLATE_TOP(compute_attention_d128_b16_HLS,     attn_cfg_d128_b16,     N, 128, 128, 16, 16)
+ATTN_TEMPLATE_TOP(compute_attention_d128_b32_HLS,     attn_cfg_d128_b32,     N, 128, 128, 32, 32)
+ATTN_TEMPLATE_TOP(compute_attention_d128_b64_HLS,     attn_cfg_d128_b64,     N, 128, 128, 64, 64)
+ATTN_TEMPLATE_TOP(compute_attention_d64_b32_wide_HLS, attn_cfg_d64_b32_wide, N, 64,  64,  32, 32)
@@ -5,14 +5,28 @@ void compute_attention_HLS(
     qint8_t Q[N][dk],           
     qint8_t K[N][dk],           
     qint8_t V[N][dv],           
-    fixed_t Output[N][dv],     
+    out_t Output[N][dv],     
     float scale_Q[N],         
     float scale_K[N],          
-    float scale_V[N]           
+    float scale_V[N],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+#if BLOCK_SPARSE
+    int kv_block_ptr[SPARSE_Q_TILES + 1],
+    int kv_block_idx[SPARSE_MAX_BLOCKS],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal
 ) {
     //bus[0]
     #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=N*dk
     #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=N
+#if BLOCK_SPARSE
+    #pragma HLS INTERFACE mode=m_axi port=kv_block_ptr bundle=gmem0 depth=SPARSE_Q_TILES+1
+    #pragma HLS INTERFACE mode=m_axi port=kv_block_idx bundle=gmem0 depth=SPARSE_MAX_BLOCKS
+#endif
 
     //bus[1]
     #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=N*dk
@@ -24,7 +38,13 @@ void compute_attention_HLS(
 
     //bus[3]
     #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=N
+#endif
 
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
     #pragma HLS INTERFACE mode=s_axilite port=return
 
     // Local buffers for Q (single buffer)
@@ -47,6 +67,16 @@ void compute_attention_HLS(
     scale_fixed_t local_scale_K[2][Bc];
     scale_fixed_t local_scale_V[2][Bc];
 
+    // K/V 상주 버퍼 - URAM 매핑 (seq_len <= KV_RESIDENT_MAX 일 때 사용)
+    qint8_t res_K[KV_RESIDENT_MAX][dk];
+    #pragma HLS BIND_STORAGE variable=res_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_K cyclic factor=4 dim=2
+    qint8_t res_V[KV_RESIDENT_MAX][dv];
+    #pragma HLS BIND_STORAGE variable=res_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_V cyclic factor=4 dim=2
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX];
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX];
+
     // Output accumulators - BRAM 매핑
     ap_fixed<32,16> local_O[Br][dv];
     #pragma HLS BIND_STORAGE variable=local_O type=ram_2p impl=bram
@@ -56,18 +86,50 @@ void compute_attention_HLS(
     ap_fixed<32,16> local_l[Br];
     #pragma HLS ARRAY_PARTITION variable=local_l complete
 
-    const int num_kv_blocks = N / Bc;
+    // 1/sqrt(head_dim) - head_dim=64 이면 기존 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // K/V 상주 모드: 전체 K/V 를 한 번만 DDR 에서 읽고 모든 Q 타일에서 재사용
+    // (스트리밍 모드는 Q 타일마다 K/V 전체를 다시 읽음 -> N/Br 배 트래픽)
+    bool kv_resident = (seq_len <= KV_RESIDENT_MAX);
+
+#if BLOCK_SPARSE
+    // active 블록 CSR - 시작할 때 온칩으로
+    int blk_ptr[SPARSE_Q_TILES + 1];
+    int blk_idx[SPARSE_MAX_BLOCKS];
+    load_block_list(kv_block_ptr, kv_block_idx, seq_len, blk_ptr, blk_idx);
+#endif
+
+    if (kv_resident) {
+        LOAD_KV_RESIDENT:
+        for (int c = 0; c < seq_len; c++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=KV_RESIDENT_MAX
+            #pragma HLS PIPELINE II=1
+            res_scale_K[c] = (scale_fixed_t)scale_K[c];
+            res_scale_V[c] = (scale_fixed_t)scale_V[c];
+            for (int k = 0; k < dk; k++) {
+                res_K[c][k] = (k < head_dim) ? K[c][k] : (qint8_t)0;
+            }
+            for (int v = 0; v < dv; v++) {
+                res_V[c][v] = (v < head_dim) ? V[c][v] : (qint8_t)0;
+            }
+            DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+        }
+    }
 
     OUTER_Q_LOOP:
-    for (int i = 0; i < N; i += Br) {
+    for (int i = 0; i < seq_len; i += Br) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
 
-        // Load Q block and scales
+        // Load Q block and scales (seq_len 밖의 행, head_dim 밖의 열은 0)
         LOAD_Q:
         for (int r = 0; r < Br; r++) {
             #pragma HLS PIPELINE II=1
-            local_scale_Q[r] = (scale_fixed_t)scale_Q[i + r];
+            bool row_valid = (i + r < seq_len);
+            local_scale_Q[r] = row_valid ? (scale_fixed_t)scale_Q[i + r] : (scale_fixed_t)0;
+            if (row_valid) DDR_READ(head_dim * QINT8_BYTES + SCALE_BYTES);
             for (int k = 0; k < dk; k++) {
-                local_Q[r][k] = Q[i + r][k];
+                local_Q[r][k] = (row_valid && k < head_dim) ? Q[i + r][k] : (qint8_t)0;
             }
         }
 
@@ -83,41 +145,66 @@ void compute_attention_HLS(
             }
         }
 
-        // Prefetch first KV block into buffer 0
+#if BLOCK_SPARSE
+        // 이 Q 타일의 active KV 블록만 - prefetch 도 목록의 다음 블록을 따라감
+        int blk_base = blk_ptr[i / Br];
+        int num_kv_blocks = blk_ptr[i / Br + 1] - blk_base;
+        int j_first = (num_kv_blocks > 0) ? blk_idx[blk_base] * Bc : 0;
+#else
+        // causal 이면 대각 블록까지만
+        int num_kv_blocks = (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc;
+        int j_first = 0;
+#endif
+
+        // Prefetch first KV block into buffer 0 (상주 모드면 URAM 에서, 아니면 DDR 에서)
         PREFETCH_FIRST_KV:
         for (int c = 0; c < Bc; c++) {
             #pragma HLS PIPELINE II=1
-            local_scale_K[0][c] = (scale_fixed_t)scale_K[c];
-            local_scale_V[0][c] = (scale_fixed_t)scale_V[c];
+            int kv_row = j_first + c;
+            bool row_valid = (num_kv_blocks > 0 && kv_row < seq_len);
+            local_scale_K[0][c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_K[kv_row] : (scale_fixed_t)scale_K[kv_row];
+            local_scale_V[0][c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_V[kv_row] : (scale_fixed_t)scale_V[kv_row];
             for (int k = 0; k < dk; k++) {
-                local_K[0][c][k] = K[c][k];
+                local_K[0][c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : kv_resident ? res_K[kv_row][k] : K[kv_row][k];
             }
             for (int v = 0; v < dv; v++) {
-                local_V[0][c][v] = V[c][v];
+                local_V[0][c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : kv_resident ? res_V[kv_row][v] : V[kv_row][v];
             }
+            if (row_valid && !kv_resident) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
         }
 
         OUTER_KV_LOOP:
         for (int jb = 0; jb < num_kv_blocks; jb++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Bc
 
             int curr_buf = jb & 1;        // 0, 1, 0, 1, ...
             int next_buf = 1 - curr_buf;  // 1, 0, 1, 0, ...
-            int j_next = (jb + 1) * Bc;
             bool has_next = (jb < num_kv_blocks - 1);
+#if BLOCK_SPARSE
+            int j = blk_idx[blk_base + jb] * Bc;
+            int j_next = has_next ? blk_idx[blk_base + jb + 1] * Bc : 0;
+#else
+            int j = jb * Bc;
+            int j_next = (jb + 1) * Bc;
+#endif
+            bool diag_tile = is_diag_tile(i, j, causal);
 
             // Load next KV block (if exists)
             if (has_next) {
                 LOAD_KV_NEXT:
                 for (int c = 0; c < Bc; c++) {
                     #pragma HLS PIPELINE II=1
-                    local_scale_K[next_buf][c] = (scale_fixed_t)scale_K[j_next + c];
-                    local_scale_V[next_buf][c] = (scale_fixed_t)scale_V[j_next + c];
+                    int kv_row = j_next + c;
+                    bool row_valid = (kv_row < seq_len);
+                    local_scale_K[next_buf][c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_K[kv_row] : (scale_fixed_t)scale_K[kv_row];
+                    local_scale_V[next_buf][c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_V[kv_row] : (scale_fixed_t)scale_V[kv_row];
                     for (int k = 0; k < dk; k++) {
-                        local_K[next_buf][c][k] = K[j_next + c][k];
+                        local_K[next_buf][c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : kv_resident ? res_K[kv_row][k] : K[kv_row][k];
                     }
                     for (int v = 0; v < dv; v++) {
-                        local_V[next_buf][c][v] = V[j_next + c][v];
+                        local_V[next_buf][c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : kv_resident ? res_V[kv_row][v] : V[kv_row][v];
                     }
+                    if (row_valid && !kv_resident) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
                 }
             }
 
@@ -142,7 +229,12 @@ void compute_attention_HLS(
 
                     auto combined_scale = local_scale_Q[r] * local_scale_K[curr_buf][c];
                     auto raw_score = score_sum_int * combined_scale;
-                    scores[c] = (ap_fixed<32, 16>)(raw_score >> 3);
+                    scores[c] = (ap_fixed<32, 16>)(raw_score * attn_scale);
+
+                    // seq_len 밖 열, 대각 타일의 상삼각은 마스킹
+                    if (is_masked(i + r, j + c, seq_len, diag_tile)) {
+                        scores[c] = -10000.0;
+                    }
 
                     if (scores[c] > row_max_val) {
                         row_max_val = scores[c];
@@ -151,7 +243,7 @@ void compute_attention_HLS(
 
                 ap_fixed<32,16> m_prev = local_m[r];
                 ap_fixed<32,16> m_new = (m_prev > row_max_val) ? m_prev : row_max_val;
-                ap_fixed<32,16> correction_prev = hls::exp((float)(m_prev - m_new));
+                ap_fixed<32,16> correction_prev = attn_exp(m_prev - m_new);
 
                 ap_fixed<32,16> p_sum_curr = 0;
                 ap_fixed<32,16> P[Bc];
@@ -160,7 +252,7 @@ void compute_attention_HLS(
                 SOFTMAX_LOOP:
                 for (int c = 0; c < Bc; c++) {
                     #pragma HLS PIPELINE II=1
-                    P[c] = hls::exp((float)(scores[c] - m_new));
+                    P[c] = !is_masked(i + r, j + c, seq_len, diag_tile) ? attn_exp(scores[c] - m_new) : (ap_fixed<32,16>)0;
                     p_sum_curr += P[c];
                 }
 
@@ -173,9 +265,42 @@ void compute_attention_HLS(
                     scaled_P[c] = P[c] * local_scale_V[curr_buf][c];
                 }
 
+#if INT8_PV
+                // P * scale_V -> uint8 (row 별 2^pv_shift step), OUTPUT_UPDATE 는 int8 x int8 -> int32 MAC
+                ap_fixed<32,16> p_max = 0;
+                PV_MAX_LOOP:
+                for (int c = 0; c < Bc; c++) {
+                    #pragma HLS PIPELINE II=1
+                    if (scaled_P[c] > p_max) p_max = scaled_P[c];
+                }
+                int pv_shift = pv_quant_shift(p_max);
+
+                ap_uint<8> q_P[Bc];
+                #pragma HLS ARRAY_PARTITION variable=q_P complete
+                PV_QUANT_LOOP:
+                for (int c = 0; c < Bc; c++) {
+                    #pragma HLS PIPELINE II=1
+                    q_P[c] = pv_quant(scaled_P[c], pv_shift);
+                }
+#endif
+
                 local_l[r] = local_l[r] * correction_prev + p_sum_curr;
                 local_m[r] = m_new;
 
+#if INT8_PV
+                OUTPUT_UPDATE:
+                for (int v = 0; v < dv; v++) {
+                    #pragma HLS PIPELINE II=1
+                    qint32_t pv_acc = 0;
+
+                    WEIGHTED_SUM:
+                    for (int c = 0; c < Bc; c++) {
+                        #pragma HLS UNROLL factor=4
+                        pv_acc += q_P[c] * local_V[curr_buf][c][v];
+                    }
+                    local_O[r][v] = local_O[r][v] * correction_prev + pv_dequant(pv_acc, pv_shift);
+                }
+#else
                 OUTPUT_UPDATE:
                 for (int v = 0; v < dv; v++) {
                     #pragma HLS PIPELINE II=1
@@ -189,16 +314,41 @@ void compute_attention_HLS(
                     }
                     local_O[r][v] = local_O[r][v] * correction_prev + weighted_sum;
                 }
+#endif
             } // end PROCESS_ROW
         } // end OUTER_KV_LOOP
 
         WRITE_OUTPUT:
         for (int r = 0; r < Br; r++) {
             #pragma HLS PIPELINE II=1
-            ap_fixed<32,16> inv_sum = ap_fixed<32, 16>(1.0) / local_l[r];
+            ap_fixed<32,16> inv_sum = attn_recip(local_l[r]);
+#if INT8_OUTPUT
+            // 정규화하면서 행 absmax -> int8 + Output_scale (quant_row 와 같은 규칙)
+            fixed_t o_row[dv];
+            #pragma HLS ARRAY_PARTITION variable=o_row complete
+            qint8_t q_row[dv];
+            #pragma HLS ARRAY_PARTITION variable=q_row complete
+            for (int v = 0; v < dv; v++) {
+                o_row[v] = (fixed_t)(local_O[r][v] * inv_sum);
+            }
+            quant_abs_t o_absmax = quant_row_absmax<dv>(o_row, head_dim, q_row);
+            if (i + r < seq_len) {
+                DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+                Output_scale[i + r] = quant_out_scale(o_absmax);
+            }
             for (int v = 0; v < dv; v++) {
-                Output[i + r][v] = (fixed_t)(local_O[r][v] * inv_sum);
+                if (i + r < seq_len && v < head_dim) {
+                    Output[i + r][v] = q_row[v];
+                }
+            }
+#else
+            if (i + r < seq_len) DDR_WRITE(head_dim * OUTPUT_BYTES);
+            for (int v = 0; v < dv; v++) {
+                if (i + r < seq_len && v < head_dim) {
+                    Output[i + r][v] = (fixed_t)(local_O[r][v] * inv_sum);
+                }
             }
+#endif
         }
     } // end OUTER_Q_LOOP
 }
\ No newline at end of file
@@ -1,22 +1,38 @@
 #include "dcl_optimized.h"
 
+#if BLOCK_SPARSE
+#error "BLOCK_SPARSE is implemented in the DATAFLOW and typecasting_doublebuffer variants only"
+#endif
+
 
 void compute_attention_HLS(
     qint8_t Q[N][dk],           
     qint8_t K[N][dk],           
     qint8_t V[N][dv],           
-    fixed_t Output[N][dv],     
+    out_t Output[N][dv],     
     float scale_Q[N],         
     float scale_K[N],          
-    float scale_V[N]           
+    float scale_V[N],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal
 ) {
     #pragma HLS INTERFACE mode=m_axi port=Q bundle=gmem0 depth=N*dk
     #pragma HLS INTERFACE mode=m_axi port=K bundle=gmem0 depth=N*dk
     #pragma HLS INTERFACE mode=m_axi port=V bundle=gmem0 depth=N*dv
     #pragma HLS INTERFACE mode=m_axi port=Output bundle=gmem1 depth=N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem1 depth=N
+#endif
     #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem2 depth=N
     #pragma HLS INTERFACE mode=m_axi port=scale_K bundle=gmem2 depth=N
     #pragma HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=N
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
     #pragma HLS INTERFACE mode=s_axilite port=return
 
     // Local buffers
@@ -39,18 +55,21 @@ void compute_attention_HLS(
     ap_fixed<32,16> local_l[Br];
     #pragma HLS ARRAY_PARTITION variable=local_l complete
 
-    float attention_scale = 1.0f / hls::sqrt((float)dk);
+    float attention_scale = 1.0f / hls::sqrt((float)head_dim);
 
     OUTER_Q_LOOP:
-    for (int i = 0; i < N; i += Br) {
+    for (int i = 0; i < seq_len; i += Br) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
         
-        // Load Q block and scales
+        // Load Q block and scales (seq_len 밖의 행, head_dim 밖의 열은 0)
         LOAD_Q:
         for (int r = 0; r < Br; r++) {
             #pragma HLS PIPELINE II=1
-            local_scale_Q[r] = scale_Q[i + r];
+            bool row_valid = (i + r < seq_len);
+            local_scale_Q[r] = row_valid ? scale_Q[i + r] : 0.0f;
+            if (row_valid) DDR_READ(head_dim * QINT8_BYTES + SCALE_BYTES);
             for (int k = 0; k < dk; k++) {
-                local_Q[r][k] = Q[i + r][k];
+                local_Q[r][k] = (row_valid && k < head_dim) ? Q[i + r][k] : (qint8_t)0;
             }
         }
 
@@ -66,20 +85,28 @@ void compute_attention_HLS(
             }
         }
 
+        // causal 이면 대각 블록까지만
+        int kv_end = kv_range_end(i, seq_len, causal);
+
         OUTER_KV_LOOP:
-        for (int j = 0; j < N; j += Bc) {
+        for (int j = 0; j < kv_end; j += Bc) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Bc
+
+            bool diag_tile = is_diag_tile(i, j, causal);
 
             // Load K, V blocks and scales
             LOAD_KV:
             for (int c = 0; c < Bc; c++) {
                 #pragma HLS PIPELINE II=1
-                local_scale_K[c] = scale_K[j + c];
-                local_scale_V[c] = scale_V[j + c];
+                bool row_valid = (j + c < seq_len);
+                local_scale_K[c] = row_valid ? scale_K[j + c] : 0.0f;
+                local_scale_V[c] = row_valid ? scale_V[j + c] : 0.0f;
+                if (row_valid) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
                 for (int k = 0; k < dk; k++) {
-                    local_K[c][k] = K[j + c][k];
+                    local_K[c][k] = (row_valid && k < head_dim) ? K[j + c][k] : (qint8_t)0;
                 }
                 for (int v = 0; v < dv; v++) {
-                    local_V[c][v] = V[j + c][v];
+                    local_V[c][v] = (row_valid && v < head_dim) ? V[j + c][v] : (qint8_t)0;
                 }
             }
 
@@ -105,6 +132,11 @@ void compute_attention_HLS(
                     float dequant_scale = local_scale_Q[r] * local_scale_K[c] * attention_scale;
                     scores[c] = (ap_fixed<32,16>)((float)score_sum_int * dequant_scale);
 
+                    // seq_len 밖 열, 대각 타일의 상삼각은 마스킹
+                    if (is_masked(i + r, j + c, seq_len, diag_tile)) {
+                        scores[c] = -10000.0;
+                    }
+
                     if (scores[c] > row_max_val) {
                         row_max_val = scores[c];
                     }
@@ -112,7 +144,7 @@ void compute_attention_HLS(
 
                 ap_fixed<32,16> m_prev = local_m[r];
                 ap_fixed<32,16> m_new = (m_prev > row_max_val) ? m_prev : row_max_val;
-                ap_fixed<32,16> correction_prev = hls::exp((float)(m_prev - m_new));
+                ap_fixed<32,16> correction_prev = attn_exp(m_prev - m_new);
 
                 ap_fixed<32,16> p_sum_curr = 0;
                 ap_fixed<32,16> P[Bc];
@@ -121,7 +153,7 @@ void compute_attention_HLS(
                 SOFTMAX_LOOP:
                 for (int c = 0; c < Bc; c++) {
                     #pragma HLS PIPELINE II=1
-                    P[c] = hls::exp((float)(scores[c] - m_new)); 
+                    P[c] = !is_masked(i + r, j + c, seq_len, diag_tile) ? attn_exp(scores[c] - m_new) : (ap_fixed<32,16>)0;
                     p_sum_curr += P[c];
                 }
 
@@ -148,10 +180,34 @@ void compute_attention_HLS(
         WRITE_OUTPUT:
         for (int r = 0; r < Br; r++) {
             #pragma HLS PIPELINE II=1
-            ap_fixed<32,16> inv_sum = ap_fixed<32, 16>(1.0) / local_l[r];
+            ap_fixed<32,16> inv_sum = attn_recip(local_l[r]);
+#if INT8_OUTPUT
+            // 정규화하면서 행 absmax -> int8 + Output_scale (quant_row 와 같은 규칙)
+            fixed_t o_row[dv];
+            #pragma HLS ARRAY_PARTITION variable=o_row complete
+            qint8_t q_row[dv];
+            #pragma HLS ARRAY_PARTITION variable=q_row complete
+            for (int v = 0; v < dv; v++) {
+                o_row[v] = (fixed_t)(local_O[r][v] * inv_sum);
+            }
+            quant_abs_t o_absmax = quant_row_absmax<dv>(o_row, head_dim, q_row);
+            if (i + r < seq_len) {
+                DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+                Output_scale[i + r] = quant_out_scale(o_absmax);
+            }
+            for (int v = 0; v < dv; v++) {
+                if (i + r < seq_len && v < head_dim) {
+                    Output[i + r][v] = q_row[v];
+                }
+            }
+#else
+            if (i + r < seq_len) DDR_WRITE(head_dim * OUTPUT_BYTES);
             for (int v = 0; v < dv; v++) {
-                Output[i + r][v] = (fixed_t)(local_O[r][v] * inv_sum);
+                if (i + r < seq_len && v < head_dim) {
+                    Output[i + r][v] = (fixed_t)(local_O[r][v] * inv_sum);
+                }
             }
+#endif
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// Ragged (variable-length) batch variant
+// --------------------------------------------------------
+// 시퀀스 batch 개를 padding 없이 이어 붙인 flat 토큰 버퍼 [MAX_VARLEN_TOKENS][dk] 하나로 받음
+// 시퀀스 b 는 토큰 [cu_seqlens[b], cu_seqlens[b+1]) - 커널 안에서는 seq_off 만큼 밀어서 [0, seq_len) 로 봄
+// Q 타일 / KV 타일 루프는 시퀀스 길이 기준 (시퀀스 경계를 넘는 attention / padding 계산 없음)
+// 시퀀스 하나의 datapath (K/V 상주, Q 타일 3-stage DATAFLOW) 는 DATAFLOW variant 와 동일
+// process / compute stage 는 flash_attention_tmpl.h (attn_cfg_default), 이 파일은 seq_off 로더와 kv_source_varlen
+
+// K/V 상주 로드 함수 - 시퀀스 하나의 K, V 를 DDR 에서 한 번만 읽어서 온칩(URAM) 버퍼 [0, seq_len) 에 저장
+void load_kv_resident_varlen(
+    qint8_t K[MAX_VARLEN_TOKENS][dk],
+    qint8_t V[MAX_VARLEN_TOKENS][dv],
+    float scale_K[MAX_VARLEN_TOKENS],
+    float scale_V[MAX_VARLEN_TOKENS],
+    int seq_off,
+    int seq_len,
+    int head_dim,
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_KV_RESIDENT:
+    for (int c = 0; c < seq_len; c++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=KV_RESIDENT_MAX
+        #pragma HLS PIPELINE II=1
+        res_scale_K[c] = (scale_fixed_t)scale_K[seq_off + c];
+        res_scale_V[c] = (scale_fixed_t)scale_V[seq_off + c];
+        for (int k = 0; k < dk; k++) {
+            res_K[c][k] = (k < head_dim) ? K[seq_off + c][k] : (qint8_t)0;
+        }
+        for (int v = 0; v < dv; v++) {
+            res_V[c][v] = (v < head_dim) ? V[seq_off + c][v] : (qint8_t)0;
+        }
+        DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// Load KV 함수 - K, V 블록을 PIPO 버퍼 (kv_K, kv_V, scale) 에 바로 씀
+// 상주 모드면 온칩 버퍼에서, 아니면 메모리(DDR)에서 읽음
+void load_kv_task_varlen(
+    qint8_t K[MAX_VARLEN_TOKENS][dk],
+    qint8_t V[MAX_VARLEN_TOKENS][dv],
+    float scale_K[MAX_VARLEN_TOKENS],
+    float scale_V[MAX_VARLEN_TOKENS],
+    qint8_t res_K[KV_RESIDENT_MAX][dk],
+    qint8_t res_V[KV_RESIDENT_MAX][dv],
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX],
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX],
+    bool kv_resident,
+    int j,
+    int seq_off,
+    int seq_len,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    // seq_len 밖의 행 (다음 시퀀스 토큰), head_dim 밖의 열은 0
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        int tok = seq_off + kv_row;
+        bool row_valid = (kv_row < seq_len);
+        kv_scale_K[c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_K[kv_row] : (scale_fixed_t)scale_K[tok];
+        kv_scale_V[c] = !row_valid ? (scale_fixed_t)0 : kv_resident ? res_scale_V[kv_row] : (scale_fixed_t)scale_V[tok];
+        for (int k = 0; k < dk; k++) {
+            kv_K[c][k] = !(row_valid && k < head_dim) ? (qint8_t)0 : kv_resident ? res_K[kv_row][k] : K[tok][k];
+        }
+        for (int v = 0; v < dv; v++) {
+            kv_V[c][v] = !(row_valid && v < head_dim) ? (qint8_t)0 : kv_resident ? res_V[kv_row][v] : V[tok][v];
+        }
+        if (row_valid && !kv_resident) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+    }
+}
+
+// KV source - 시퀀스 안 상대 위치 (i, j) 로 루프 / 마스크, 로더만 seq_off 를 더함
+struct kv_source_varlen {
+    static const int MAX_BLOCKS   = N / Bc;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*K)[dk];
+    qint8_t (*V)[dv];
+    float* scale_K;
+    float* scale_V;
+    qint8_t (*res_K)[dk];
+    qint8_t (*res_V)[dv];
+    scale_fixed_t* res_scale_K;
+    scale_fixed_t* res_scale_V;
+    bool kv_resident;
+    int seq_off;
+    int seq_len;
+    int head_dim;
+    bool causal;
+
+    int first_block(int) const { return 0; }
+    int end_block(int i) const { return (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const { return attn_causal_mask(seq_len, is_diag_tile(i, j, causal)); }
+
+    void load(int, int, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        load_kv_task_varlen(K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                            kv_resident, j, seq_off, seq_len, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+
+// --------------------------------------------------------
+// 시퀀스마다 Q 타일 단위 3-stage DATAFLOW:  load_q_task_varlen(i+1) | compute_q_tile_tmpl(i) | write_output_task_varlen(i-1)
+// tile 버퍼 (tile_Q, tile_scale_Q, tile_O) 는 OUTER_Q_LOOP 안에 선언되어 PIPO(ping-pong) 로 매핑됨
+// --------------------------------------------------------
+
+// Load Q 함수 - Q 타일과 scale 을 DDR 에서 읽음 (seq_len 밖의 행, head_dim 밖의 열은 0)
+void load_q_task_varlen(
+    qint8_t Q[MAX_VARLEN_TOKENS][dk],
+    float scale_Q[MAX_VARLEN_TOKENS],
+    int i,
+    int seq_off,
+    int seq_len,
+    int head_dim,
+    qint8_t tile_Q[Br][dk],
+    scale_fixed_t tile_scale_Q[Br]
+) {
+    #pragma HLS INLINE off
+
+    LOAD_Q:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+        bool row_valid = (i + r < seq_len);
+        tile_scale_Q[r] = row_valid ? (scale_fixed_t)scale_Q[seq_off + i + r] : (scale_fixed_t)0;
+        if (row_valid) DDR_READ(head_dim * QINT8_BYTES + SCALE_BYTES);
+        for (int k = 0; k < dk; k++) {
+            tile_Q[r][k] = (row_valid && k < head_dim) ? Q[seq_off + i + r][k] : (qint8_t)0;
+        }
+    }
+}
+
+// Write 함수 - 정규화된 출력 타일을 DDR 로 (seq_len / head_dim 밖은 쓰지 않음)
+// INT8_OUTPUT: 정규화된 tile_O 행을 writeback 직전에 양자화 (absmax -> int8 + Output_scale)
+void write_output_task_varlen(
+    fixed_t tile_O[Br][dv],
+    int i,
+    int seq_off,
+    int seq_len,
+    int head_dim,
+#if INT8_OUTPUT
+    float Output_scale[MAX_VARLEN_TOKENS],
+#endif
+    out_t Output[MAX_VARLEN_TOKENS][dv]
+) {
+    #pragma HLS INLINE off
+
+    WRITE_OUTPUT:
+    for (int r = 0; r < Br; r++) {
+        #pragma HLS PIPELINE II=1
+#if INT8_OUTPUT
+        qint8_t q_row[dv];
+        #pragma HLS ARRAY_PARTITION variable=q_row complete
+        quant_abs_t o_absmax = quant_row_absmax<dv>(tile_O[r], head_dim, q_row);
+        if (i + r < seq_len) {
+            DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+            Output_scale[seq_off + i + r] = quant_out_scale(o_absmax);
+        }
+        for (int v = 0; v < dv; v++) {
+            if (i + r < seq_len && v < head_dim) {
+                Output[seq_off + i + r][v] = q_row[v];
+            }
+        }
+#else
+        if (i + r < seq_len) DDR_WRITE(head_dim * OUTPUT_BYTES);
+        for (int v = 0; v < dv; v++) {
+            if (i + r < seq_len && v < head_dim) {
+                Output[seq_off + i + r][v] = tile_O[r][v];
+            }
+        }
+#endif
+    }
+}
+
+
+void compute_attention_varlen_HLS(
+    qint8_t Q[MAX_VARLEN_TOKENS][dk],
+    qint8_t K[MAX_VARLEN_TOKENS][dk],
+    qint8_t V[MAX_VARLEN_TOKENS][dv],
+    out_t Output[MAX_VARLEN_TOKENS][dv],
+    float scale_Q[MAX_VARLEN_TOKENS],
+    float scale_K[MAX_VARLEN_TOKENS],
+    float scale_V[MAX_VARLEN_TOKENS],
+#if INT8_OUTPUT
+    float Output_scale[MAX_VARLEN_TOKENS],
+#endif
+    int cu_seqlens[MAX_BATCH + 1],
+    int batch,
+    int head_dim,
+    bool causal
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q          bundle=gmem0 depth=MAX_VARLEN_TOKENS*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_Q    bundle=gmem0 depth=MAX_VARLEN_TOKENS
+    #pragma HLS INTERFACE mode=m_axi port=cu_seqlens bundle=gmem0 depth=MAX_BATCH+1
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=MAX_VARLEN_TOKENS*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_K bundle=gmem1 depth=MAX_VARLEN_TOKENS
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=MAX_VARLEN_TOKENS*dv
+    #pragma HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=MAX_VARLEN_TOKENS
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=MAX_VARLEN_TOKENS*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=MAX_VARLEN_TOKENS
+#endif
+
+    #pragma HLS INTERFACE mode=s_axilite port=batch
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // K/V 상주 버퍼 - URAM 매핑 (시퀀스 길이 <= KV_RESIDENT_MAX 일 때 사용, 시퀀스마다 다시 채움)
+    qint8_t res_K[KV_RESIDENT_MAX][dk];
+    #pragma HLS BIND_STORAGE variable=res_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_K cyclic factor=4 dim=2
+    qint8_t res_V[KV_RESIDENT_MAX][dv];
+    #pragma HLS BIND_STORAGE variable=res_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=res_V cyclic factor=4 dim=2
+    scale_fixed_t res_scale_K[KV_RESIDENT_MAX];
+    scale_fixed_t res_scale_V[KV_RESIDENT_MAX];
+
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // cu_seqlens 는 시작할 때 온칩으로 (batch + 1 개)
+    int seq_bounds[MAX_BATCH + 1];
+    #pragma HLS ARRAY_PARTITION variable=seq_bounds complete
+
+    if (batch > MAX_BATCH) batch = MAX_BATCH;
+
+    LOAD_CU_SEQLENS:
+    for (int b = 0; b <= MAX_BATCH; b++) {
+        #pragma HLS PIPELINE II=1
+        seq_bounds[b] = (b <= batch) ? cu_seqlens[b] : 0;
+        if (b <= batch) DDR_READ(CU_SEQLENS_BYTES);
+    }
+
+    SEQ_LOOP:
+    for (int b = 0; b < batch; b++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_BATCH
+
+        int seq_off = seq_bounds[b];
+        int seq_end = seq_bounds[b + 1];
+        // flat 버퍼 밖에서 시작하거나 감소하는 (빈) 시퀀스는 skip, 끝은 MAX_VARLEN_TOKENS 로 자름
+        if (seq_off < 0 || seq_off >= MAX_VARLEN_TOKENS || seq_end <= seq_off) continue;
+        if (seq_end > MAX_VARLEN_TOKENS) seq_end = MAX_VARLEN_TOKENS;
+        // 시퀀스 하나는 N 토큰까지 (온칩 버퍼 / 타일 루프 상한)
+        int seq_len = seq_end - seq_off;
+        if (seq_len > N) seq_len = N;
+
+        // K/V 상주 모드: 이 시퀀스의 K/V 를 한 번만 DDR 에서 읽고 모든 Q 타일에서 재사용
+        bool kv_resident = (seq_len <= KV_RESIDENT_MAX);
+
+        if (kv_resident) {
+            load_kv_resident_varlen(K, V, scale_K, scale_V, seq_off, seq_len, head_dim,
+                                    res_K, res_V, res_scale_K, res_scale_V);
+        }
+
+        kv_source_varlen src = { K, V, scale_K, scale_V, res_K, res_V, res_scale_K, res_scale_V,
+                                 kv_resident, seq_off, seq_len, head_dim, causal };
+
+        // padding 없이 이 시퀀스의 Q 타일 수만큼
+        int num_q_tiles = (seq_len + Br - 1) / Br;
+
+        OUTER_Q_LOOP:
+        for (int ib = 0; ib < num_q_tiles; ib++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+            #pragma HLS DATAFLOW
+
+            int i = ib * Br;
+
+            // Q 타일 / 출력 타일 ping-pong 버퍼
+            qint8_t tile_Q[Br][dk];
+            #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+            #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+            scale_fixed_t tile_scale_Q[Br];
+            #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+            fixed_t tile_O[Br][dv];
+            #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+            load_q_task_varlen(Q, scale_Q, i, seq_off, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+            compute_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+#if INT8_OUTPUT
+            write_output_task_varlen(tile_O, i, seq_off, seq_len, head_dim, Output_scale, Output);
+#else
+            write_output_task_varlen(tile_O, i, seq_off, seq_len, head_dim, Output);
+#endif
+        } // end OUTER_Q_LOOP
+    } // end SEQ_LOOP
+}
@@ -1,16 +1,26 @@
 #include "dcl_optimized.h"
 
-// KV260 bus width: 128-bit / 8-bit = 16
-#define BUS_PACK_FACTOR 16 
+#if BLOCK_SPARSE
+#error "BLOCK_SPARSE is implemented in the DATAFLOW and typecasting_doublebuffer variants only"
+#endif
+
+// KV260 bus width: 128-bit / 8-bit = 16 (BUS_PACK_FACTOR, dcl_optimized.h)
+// 이 버전은 원소 1개 / beat - packed 포트 버전은 top_flash_attention_packed.cpp
 
 void compute_attention_HLS(
     qint8_t Q[N][dk],           
     qint8_t K[N][dk],           
     qint8_t V[N][dv],           
-    fixed_t Output[N][dv],     
+    out_t Output[N][dv],     
     float scale_Q[N],         
     float scale_K[N],          
-    float scale_V[N]           
+    float scale_V[N],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal
 ) {
 
     //bus[0]
@@ -27,7 +37,13 @@ void compute_attention_HLS(
     
     //bus[3]
     #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=N
+#endif
     
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
     #pragma HLS INTERFACE mode=s_axilite port=return
 
 
@@ -53,20 +69,33 @@ void compute_attention_HLS(
     #pragma HLS ARRAY_PARTITION variable=local_l complete
 
 
+    // 1/sqrt(head_dim) - head_dim=64 이면 기존 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
     OUTER_Q_LOOP:
-    for (int i = 0; i < N; i += Br) {
+    for (int i = 0; i < seq_len; i += Br) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
         
+        // seq_len 밖의 행, head_dim 밖의 열은 0
         LOAD_Q_SCALE:
         for (int r = 0; r < Br; r++) {
             #pragma HLS PIPELINE II=1
-            local_scale_Q[r] = (scale_fixed_t)scale_Q[i + r];
+            local_scale_Q[r] = (i + r < seq_len) ? (scale_fixed_t)scale_Q[i + r] : (scale_fixed_t)0;
+            if (i + r < seq_len) {
+                DDR_READ(SCALE_BYTES);
+                DDR_READ_BEATS(1);
+            }
         }
 
         LOAD_Q_MATRIX:
         for (int r = 0; r < Br; r++) {
             for (int k = 0; k < dk; k++) {
                 #pragma HLS PIPELINE II=1
-                local_Q[r][k] = Q[i + r][k];
+                local_Q[r][k] = (i + r < seq_len && k < head_dim) ? Q[i + r][k] : (qint8_t)0;
+                if (i + r < seq_len && k < head_dim) {
+                    DDR_READ(QINT8_BYTES);
+                    DDR_READ_BEATS(1);
+                }
             }
         }
 
@@ -81,21 +110,35 @@ void compute_attention_HLS(
             }
         }
 
+        // causal 이면 대각 블록까지만
+        int kv_end = kv_range_end(i, seq_len, causal);
+
         OUTER_KV_LOOP:
-        for (int j = 0; j < N; j += Bc) {
+        for (int j = 0; j < kv_end; j += Bc) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Bc
+
+            bool diag_tile = is_diag_tile(i, j, causal);
          
             // --- LOAD K PART ---
             LOAD_K_SCALE:
             for (int c = 0; c < Bc; c++) {
                  #pragma HLS PIPELINE II=1
-                 local_scale_K[c] = (scale_fixed_t)scale_K[j + c];
+                 local_scale_K[c] = (j + c < seq_len) ? (scale_fixed_t)scale_K[j + c] : (scale_fixed_t)0;
+                 if (j + c < seq_len) {
+                     DDR_READ(SCALE_BYTES);
+                     DDR_READ_BEATS(1);
+                 }
             }
 
             LOAD_K_MATRIX:
             for (int c = 0; c < Bc; c++) {
                 for (int k = 0; k < dk; k++) {
                     #pragma HLS PIPELINE II=1
-                    local_K[c][k] = K[j + c][k];
+                    local_K[c][k] = (j + c < seq_len && k < head_dim) ? K[j + c][k] : (qint8_t)0;
+                    if (j + c < seq_len && k < head_dim) {
+                        DDR_READ(QINT8_BYTES);
+                        DDR_READ_BEATS(1);
+                    }
                 }
             }
 
@@ -103,14 +146,22 @@ void compute_attention_HLS(
             LOAD_V_SCALE:
             for (int c = 0; c < Bc; c++) {
                 #pragma HLS PIPELINE II=1
-                local_scale_V[c] = (scale_fixed_t)scale_V[j + c];
+                local_scale_V[c] = (j + c < seq_len) ? (scale_fixed_t)scale_V[j + c] : (scale_fixed_t)0;
+                if (j + c < seq_len) {
+                    DDR_READ(SCALE_BYTES);
+                    DDR_READ_BEATS(1);
+                }
             }
 
             LOAD_V_MATRIX:
             for (int c = 0; c < Bc; c++) {
                 for (int v = 0; v < dv; v++) {
                     #pragma HLS PIPELINE II=1
-                    local_V[c][v] = V[j + c][v];
+                    local_V[c][v] = (j + c < seq_len && v < head_dim) ? V[j + c][v] : (qint8_t)0;
+                    if (j + c < seq_len && v < head_dim) {
+                        DDR_READ(QINT8_BYTES);
+                        DDR_READ_BEATS(1);
+                    }
                 }
             }
             // -------------------
@@ -134,7 +185,12 @@ void compute_attention_HLS(
                     
                     auto combined_scale = local_scale_Q[r] * local_scale_K[c];
                     auto raw_score = score_sum_int * combined_scale;
-                    scores[c] = (ap_fixed<32, 16>)(raw_score >> 3);
+                    scores[c] = (ap_fixed<32, 16>)(raw_score * attn_scale);
+
+                    // seq_len 밖 열, 대각 타일의 상삼각은 마스킹
+                    if (is_masked(i + r, j + c, seq_len, diag_tile)) {
+                        scores[c] = -10000.0;
+                    }
 
                     if (scores[c] > row_max_val) {
                         row_max_val = scores[c];
@@ -143,7 +199,7 @@ void compute_attention_HLS(
 
                 ap_fixed<32,16> m_prev = local_m[r];
                 ap_fixed<32,16> m_new = (m_prev > row_max_val) ? m_prev : row_max_val;
-                ap_fixed<32,16> correction_prev = hls::exp((float)(m_prev - m_new));
+                ap_fixed<32,16> correction_prev = attn_exp(m_prev - m_new);
 
                 ap_fixed<32,16> p_sum_curr = 0;
                 ap_fixed<32,16> P[Bc];
@@ -152,7 +208,7 @@ void compute_attention_HLS(
                 SOFTMAX_LOOP:
                 for (int c = 0; c < Bc; c++) {
                     #pragma HLS PIPELINE II=1 
-                    P[c] = hls::exp((float)(scores[c] - m_new)); 
+                    P[c] = !is_masked(i + r, j + c, seq_len, diag_tile) ? attn_exp(scores[c] - m_new) : (ap_fixed<32,16>)0;
                     p_sum_curr += P[c];
                 }
 
@@ -162,10 +218,42 @@ void compute_attention_HLS(
                     #pragma HLS PIPELINE II=1 
                     scaled_P[c] = P[c] * local_scale_V[c];
                 }
+
+#if INT8_PV
+                // P * scale_V -> uint8 (row 별 2^pv_shift step), OUTPUT_UPDATE 는 int8 x int8 -> int32 MAC
+                ap_fixed<32,16> p_max = 0;
+                PV_MAX_LOOP:
+                for (int c = 0; c < Bc; c++) {
+                    #pragma HLS PIPELINE II=1
+                    if (scaled_P[c] > p_max) p_max = scaled_P[c];
+                }
+                int pv_shift = pv_quant_shift(p_max);
+
+                ap_uint<8> q_P[Bc];
+                #pragma HLS ARRAY_PARTITION variable=q_P complete
+                PV_QUANT_LOOP:
+                for (int c = 0; c < Bc; c++) {
+                    #pragma HLS PIPELINE II=1
+                    q_P[c] = pv_quant(scaled_P[c], pv_shift);
+                }
+#endif
                 
                 local_l[r] = local_l[r] * correction_prev + p_sum_curr;
                 local_m[r] = m_new;
 
+#if INT8_PV
+                OUTPUT_UPDATE:
+                for (int v = 0; v < dv; v++) {
+                    qint32_t pv_acc = 0;
+                    
+                    WEIGHTED_SUM:
+                    for (int c = 0; c < Bc; c++) {
+                        #pragma HLS PIPELINE II=1
+                        pv_acc += q_P[c] * local_V[c][v];
+                    }
+                    local_O[r][v] = local_O[r][v] * correction_prev + pv_dequant(pv_acc, pv_shift);
+                }
+#else
                 OUTPUT_UPDATE:
                 for (int v = 0; v < dv; v++) {
                     ap_fixed<32,16> weighted_sum = 0;
@@ -178,18 +266,48 @@ void compute_attention_HLS(
                     }
                     local_O[r][v] = local_O[r][v] * correction_prev + weighted_sum;
                 }
+#endif
             }
         }
 
 
         WRITE_OUTPUT:
         for (int r = 0; r < Br; r++) {
-            ap_fixed<32,16> inv_sum = ap_fixed<32, 16>(1.0) / local_l[r];
+            ap_fixed<32,16> inv_sum = attn_recip(local_l[r]);
+#if INT8_OUTPUT
+            // 정규화하면서 행 absmax -> int8 + Output_scale (quant_row 와 같은 규칙)
+            fixed_t o_row[dv];
+            qint8_t q_row[dv];
+            NORMALIZE_ROW:
+            for (int v = 0; v < dv; v++) {
+                #pragma HLS PIPELINE II=1
+                o_row[v] = (fixed_t)(local_O[r][v] * inv_sum);
+            }
+            quant_abs_t o_absmax = quant_row_absmax<dv>(o_row, head_dim, q_row);
+            if (i + r < seq_len) {
+                DDR_WRITE(head_dim * QINT8_BYTES + SCALE_BYTES);
+                Output_scale[i + r] = quant_out_scale(o_absmax);
+                DDR_WRITE_BEATS(1);
+            }
+
+            for (int v = 0; v < dv; v++) {
+                #pragma HLS PIPELINE II=1
+                if (i + r < seq_len && v < head_dim) {
+                    Output[i + r][v] = q_row[v];
+                    DDR_WRITE_BEATS(1);
+                }
+            }
+#else
+            if (i + r < seq_len) DDR_WRITE(head_dim * OUTPUT_BYTES);
             
             for (int v = 0; v < dv; v++) {
                 #pragma HLS PIPELINE II=1
-                Output[i + r][v] = (fixed_t)(local_O[r][v] * inv_sum);
+                if (i + r < seq_len && v < head_dim) {
+                    Output[i + r][v] = (fixed_t)(local_O[r][v] * inv_sum);
+                    DDR_WRITE_BEATS(1);
+                }
             }
+#endif
         }
     }
 }
\ No newline at end of file
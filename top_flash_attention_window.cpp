@@ -0,0 +1,206 @@
+#include "flash_attention_tmpl.h"
+
+// --------------------------------------------------------
+// Sliding-window (local) attention variant
+// --------------------------------------------------------
+// Q 타일 [i, i+Br) 는 lookback window 범위 [kv_window_start, i + Br) 의 KV 블록만 돌고 (O(seq_len * window))
+// 대각 타일은 causal 마스킹, 가장자리 타일 안의 window 밖 원소도 마스킹
+// K/V 는 KV ring (KV_RING_BLOCKS 블록) - 앞 Q 타일이 읽은 블록은 ring 에서 재사용,
+// 새 블록만 DDR 에서 읽어서 ring 에 씀 -> K/V DDR 트래픽 seq_len 1 회
+// ring 은 KV_RESIDENT_MAX 행 이상이라 seq_len <= KV_RESIDENT_MAX 면 DATAFLOW variant 의 상주 모드와 같은 트래픽
+// Q 타일 3-stage DATAFLOW / process datapath 는 flash_attention_tmpl.h (attn_cfg_default) 그대로
+// 이 파일은 ring 로더와 kv_source_window (window 범위 / 가장자리 마스크) 만
+
+// Load KV 함수 - K, V 블록을 PIPO 버퍼 (kv_K, kv_V, scale) 에 바로 씀
+// fetch 면 DDR 에서 읽고 (use_ring 이면 ring 슬롯에도 씀), 아니면 ring 슬롯에서 읽음
+void load_kv_task_window(
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    float scale_K[N],
+    float scale_V[N],
+    qint8_t ring_K[KV_RING_ROWS][dk],
+    qint8_t ring_V[KV_RING_ROWS][dv],
+    scale_fixed_t ring_scale_K[KV_RING_ROWS],
+    scale_fixed_t ring_scale_V[KV_RING_ROWS],
+    bool use_ring,
+    bool fetch,
+    int j,
+    int slot,
+    int seq_len,
+    int head_dim,
+    qint8_t kv_K[Bc][dk],
+    qint8_t kv_V[Bc][dv],
+    scale_fixed_t kv_scale_K[Bc],
+    scale_fixed_t kv_scale_V[Bc]
+) {
+    #pragma HLS INLINE off
+
+    // seq_len 밖의 행, head_dim 밖의 열은 0
+    LOAD_KV:
+    for (int c = 0; c < Bc; c++) {
+        #pragma HLS PIPELINE II=1
+        int kv_row = j + c;
+        int ring_row = slot + c;
+        bool row_valid = (kv_row < seq_len);
+        if (fetch) {
+            kv_scale_K[c] = row_valid ? (scale_fixed_t)scale_K[kv_row] : (scale_fixed_t)0;
+            kv_scale_V[c] = row_valid ? (scale_fixed_t)scale_V[kv_row] : (scale_fixed_t)0;
+            for (int k = 0; k < dk; k++) {
+                kv_K[c][k] = (row_valid && k < head_dim) ? K[kv_row][k] : (qint8_t)0;
+            }
+            for (int v = 0; v < dv; v++) {
+                kv_V[c][v] = (row_valid && v < head_dim) ? V[kv_row][v] : (qint8_t)0;
+            }
+            if (row_valid) DDR_READ(2 * head_dim * QINT8_BYTES + 2 * SCALE_BYTES);
+            if (use_ring) {
+                ring_scale_K[ring_row] = kv_scale_K[c];
+                ring_scale_V[ring_row] = kv_scale_V[c];
+                for (int k = 0; k < dk; k++) ring_K[ring_row][k] = kv_K[c][k];
+                for (int v = 0; v < dv; v++) ring_V[ring_row][v] = kv_V[c][v];
+            }
+        } else {
+            kv_scale_K[c] = ring_scale_K[ring_row];
+            kv_scale_V[c] = ring_scale_V[ring_row];
+            for (int k = 0; k < dk; k++) kv_K[c][k] = ring_K[ring_row][k];
+            for (int v = 0; v < dv; v++) kv_V[c][v] = ring_V[ring_row][v];
+        }
+    }
+}
+
+// KV source - window 안 KV 블록 [kv_window_start, kv_range_end) 만, 가장자리 타일은 window 마스크
+// window > 0 이면 causal 은 항상 true (compute_attention_window_HLS 가 non-causal window 는 거부)
+// ring 은 이 source 만 읽고 씀 (Q 타일 순서대로 - 앞 Q 타일이 읽은 블록 [0, last_fetched] 는 ring 에 있음)
+struct kv_source_window {
+    static const int MAX_BLOCKS   = KV_WINDOW_BLOCKS;
+    static const int KV_PARTITION = 4;
+
+    qint8_t (*K)[dk];
+    qint8_t (*V)[dv];
+    float* scale_K;
+    float* scale_V;
+    qint8_t (*ring_K)[dk];
+    qint8_t (*ring_V)[dv];
+    scale_fixed_t* ring_scale_K;
+    scale_fixed_t* ring_scale_V;
+    bool use_ring;
+    int seq_len;
+    int head_dim;
+    bool causal;
+    int window;
+
+    int first_block(int i) const { return kv_window_start(i, window) / Bc; }
+    int end_block(int i) const { return (kv_range_end(i, seq_len, causal) + Bc - 1) / Bc; }
+    int block_row(int, int jb) const { return jb * Bc; }
+    attn_tile_mask tile_mask(int i, int j) const {
+        attn_tile_mask m = { seq_len, is_diag_tile(i, j, causal), is_window_edge_tile(i, j, window), window };
+        return m;
+    }
+
+    void load(int i, int jb, int j, qint8_t kv_K[Bc][dk], qint8_t kv_V[Bc][dv],
+              scale_fixed_t kv_scale_K[Bc], scale_fixed_t kv_scale_V[Bc]) const {
+        #pragma HLS INLINE
+        // 앞 Q 타일까지 DDR 에서 읽은 마지막 블록 - 그 뒤 블록만 새로 읽음
+        int last_fetched = (i == 0) ? -1 : end_block(i - Br) - 1;
+        bool fetch = !use_ring || jb > last_fetched;
+        int slot = (jb % KV_RING_BLOCKS) * Bc;
+        load_kv_task_window(K, V, scale_K, scale_V, ring_K, ring_V, ring_scale_K, ring_scale_V,
+                            use_ring, fetch, j, slot, seq_len, head_dim, kv_K, kv_V, kv_scale_K, kv_scale_V);
+    }
+};
+
+
+void compute_attention_window_HLS(
+    qint8_t Q[N][dk],
+    qint8_t K[N][dk],
+    qint8_t V[N][dv],
+    out_t Output[N][dv],
+    float scale_Q[N],
+    float scale_K[N],
+    float scale_V[N],
+#if INT8_OUTPUT
+    float Output_scale[N],
+#endif
+    int seq_len,
+    int head_dim,
+    bool causal,
+    int window
+) {
+    //bus[0]
+    #pragma HLS INTERFACE mode=m_axi port=Q       bundle=gmem0 depth=N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_Q bundle=gmem0 depth=N
+
+    //bus[1]
+    #pragma HLS INTERFACE mode=m_axi port=K       bundle=gmem1 depth=N*dk
+    #pragma HLS INTERFACE mode=m_axi port=scale_K bundle=gmem1 depth=N
+
+    //bus[2]
+    #pragma HLS INTERFACE mode=m_axi port=V       bundle=gmem2 depth=N*dv
+    #pragma HLS INTERFACE mode=m_axi port=scale_V bundle=gmem2 depth=N
+
+    //bus[3]
+    #pragma HLS INTERFACE mode=m_axi port=Output  bundle=gmem3 depth=N*dv
+#if INT8_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=Output_scale bundle=gmem3 depth=N
+#endif
+
+    #pragma HLS INTERFACE mode=s_axilite port=seq_len
+    #pragma HLS INTERFACE mode=s_axilite port=head_dim
+    #pragma HLS INTERFACE mode=s_axilite port=causal
+    #pragma HLS INTERFACE mode=s_axilite port=window
+    #pragma HLS INTERFACE mode=s_axilite port=return
+
+    // window 는 lookback (미래 키 마스킹) - non-causal window 는 정의 안 됨, 아무것도 안 씀
+    if (window > 0 && !causal) return;
+
+    // KV ring - max(window 가 걸치는 KV 블록, 상주 블록) KV_RING_BLOCKS 개 (블록 jb 는 슬롯 jb % KV_RING_BLOCKS)
+    qint8_t ring_K[KV_RING_ROWS][dk];
+    #pragma HLS BIND_STORAGE variable=ring_K type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=ring_K cyclic factor=4 dim=2
+    qint8_t ring_V[KV_RING_ROWS][dv];
+    #pragma HLS BIND_STORAGE variable=ring_V type=ram_2p impl=uram
+    #pragma HLS ARRAY_PARTITION variable=ring_V cyclic factor=4 dim=2
+    scale_fixed_t ring_scale_K[KV_RING_ROWS];
+    scale_fixed_t ring_scale_V[KV_RING_ROWS];
+
+    // 1/sqrt(head_dim) - head_dim=64 이면 기존 >> 3 과 동일
+    scale_fixed_t attn_scale = (scale_fixed_t)(1.0f / hls::sqrt((float)head_dim));
+
+    // ring 에 들어가면 (시퀀스 전체 또는 window) KV 블록마다 DDR 에서 한 번만 읽음
+    // (안 들어가면: Q 타일마다 window 범위만 DDR 에서 다시 읽음 - DATAFLOW 스트리밍 모드의 [0, kv_range_end) 이하)
+    bool use_ring = kv_window_use_ring(seq_len, window);
+
+    kv_source_window src = { K, V, scale_K, scale_V, ring_K, ring_V, ring_scale_K, ring_scale_V,
+                             use_ring, seq_len, head_dim, causal, window };
+
+    int num_q_tiles = (seq_len + Br - 1) / Br;
+
+    OUTER_Q_LOOP:
+    for (int ib = 0; ib < num_q_tiles; ib++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=N/Br
+        #pragma HLS DATAFLOW
+
+        int i = ib * Br;
+
+        // Q 타일 / 출력 타일 ping-pong 버퍼
+        qint8_t tile_Q[Br][dk];
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=4 dim=2
+        #pragma HLS ARRAY_PARTITION variable=tile_Q cyclic factor=NUM_ROW_ENGINES dim=1
+        scale_fixed_t tile_scale_Q[Br];
+        #pragma HLS ARRAY_PARTITION variable=tile_scale_Q cyclic factor=NUM_ROW_ENGINES
+        fixed_t tile_O[Br][dv];
+        #pragma HLS ARRAY_PARTITION variable=tile_O cyclic factor=4 dim=2
+
+        // Stage 1: Q 타일 i 로드 (앞 타일 계산과 overlap)
+        load_q_task_tmpl<attn_cfg_default>(Q, scale_Q, i, seq_len, head_dim, tile_Q, tile_scale_Q);
+
+        // Stage 2: Q 타일 i 계산 (window KV 루프 + 정규화)
+        compute_q_tile_tmpl<attn_cfg_default>(src, tile_Q, tile_scale_Q, i, attn_scale, tile_O);
+
+        // Stage 3: Q 타일 i 출력 writeback (다음 타일 계산과 overlap)
+#if INT8_OUTPUT
+        write_output_task_tmpl<attn_cfg_default>(tile_O, i, seq_len, head_dim, Output_scale, Output);
+#else
+        write_output_task_tmpl<attn_cfg_default>(tile_O, i, seq_len, head_dim, Output);
+#endif
+    } // end OUTER_Q_LOOP
+}